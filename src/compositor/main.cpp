@@ -31,6 +31,13 @@
 
 int main(int argc, char *argv[])
 {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+    // Output windows share one context group, so that a surface
+    // shown on more than one output is uploaded only once and
+    // the same texture is used by all its views
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+#endif
+
     // Application
     GreenIsland::HomeApplication app(argc, argv);
 
@@ -74,7 +81,7 @@ int main(int argc, char *argv[])
 
     // Compositor package
     QCommandLineOption pluginOption(QStringList() << QStringLiteral("p") << QStringLiteral("compositor-plugin"),
-                                    QCoreApplication::translate("Command line parser", "Force loading the given compositor plugin"),
+                                    QCoreApplication::translate("Command line parser", "Force loading the given compositor plugin instead of the built-in shell"),
                                     QStringLiteral("plugin"));
     parser.addOption(pluginOption);
 
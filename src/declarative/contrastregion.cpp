@@ -0,0 +1,339 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:LGPL2.1+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QOpenGLShaderProgram>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGMaterial>
+#include <QtQuick/QSGTexture>
+#include <QtQuick/QSGTextureProvider>
+
+#include <GreenIsland/QuickSurface>
+
+#include "contrastregion.h"
+
+using namespace GreenIsland;
+
+static QMatrix4x4 colorMatrix(qreal contrast, qreal intensity, qreal saturation)
+{
+    QMatrix4x4 satMatrix;
+    QMatrix4x4 intMatrix;
+    QMatrix4x4 contMatrix;
+
+    // Saturation, weights are the luminance of each channel
+    if (!qFuzzyCompare(saturation, 1.0)) {
+        const qreal rval = (1.0 - saturation) * 0.2126;
+        const qreal gval = (1.0 - saturation) * 0.7152;
+        const qreal bval = (1.0 - saturation) * 0.0722;
+        satMatrix = QMatrix4x4(rval + saturation, rval, rval, 0.0,
+                               gval, gval + saturation, gval, 0.0,
+                               bval, bval, bval + saturation, 0.0,
+                               0.0, 0.0, 0.0, 1.0);
+    }
+
+    // Intensity
+    if (!qFuzzyCompare(intensity, 1.0))
+        intMatrix.scale(intensity, intensity, intensity);
+
+    // Contrast, scaled around the middle gray
+    if (!qFuzzyCompare(contrast, 1.0)) {
+        const qreal transl = (1.0 - contrast) / 2.0;
+        contMatrix = QMatrix4x4(contrast, 0.0, 0.0, 0.0,
+                                0.0, contrast, 0.0, 0.0,
+                                0.0, 0.0, contrast, 0.0,
+                                transl, transl, transl, 1.0);
+    }
+
+    return (contMatrix * satMatrix * intMatrix).transposed();
+}
+
+/*
+ * ContrastMaterial
+ */
+
+class ContrastMaterial : public QSGMaterial
+{
+public:
+    ContrastMaterial();
+
+    QSGMaterialType *type() const Q_DECL_OVERRIDE;
+    QSGMaterialShader *createShader() const Q_DECL_OVERRIDE;
+    int compare(const QSGMaterial *other) const Q_DECL_OVERRIDE;
+
+    QSGTexture *texture;
+    QMatrix4x4 colorMatrix;
+};
+
+/*
+ * ContrastShader
+ */
+
+class ContrastShader : public QSGMaterialShader
+{
+public:
+    ContrastShader();
+
+    const char *vertexShader() const Q_DECL_OVERRIDE;
+    const char *fragmentShader() const Q_DECL_OVERRIDE;
+    char const *const *attributeNames() const Q_DECL_OVERRIDE;
+
+    void updateState(const RenderState &state, QSGMaterial *newMaterial,
+                     QSGMaterial *oldMaterial) Q_DECL_OVERRIDE;
+
+protected:
+    void initialize() Q_DECL_OVERRIDE;
+
+private:
+    int m_matrixId;
+    int m_opacityId;
+    int m_colorMatrixId;
+};
+
+ContrastShader::ContrastShader()
+    : m_matrixId(-1)
+    , m_opacityId(-1)
+    , m_colorMatrixId(-1)
+{
+}
+
+const char *ContrastShader::vertexShader() const
+{
+    return "uniform highp mat4 qt_Matrix;\n"
+           "attribute highp vec4 qt_Vertex;\n"
+           "attribute highp vec2 qt_MultiTexCoord0;\n"
+           "varying highp vec2 texCoord;\n"
+           "void main() {\n"
+           "    texCoord = qt_MultiTexCoord0;\n"
+           "    gl_Position = qt_Matrix * qt_Vertex;\n"
+           "}\n";
+}
+
+const char *ContrastShader::fragmentShader() const
+{
+    return "uniform sampler2D source;\n"
+           "uniform highp mat4 colorMatrix;\n"
+           "uniform lowp float opacity;\n"
+           "varying highp vec2 texCoord;\n"
+           "void main() {\n"
+           "    gl_FragColor = colorMatrix * texture2D(source, texCoord) * opacity;\n"
+           "}\n";
+}
+
+char const *const *ContrastShader::attributeNames() const
+{
+    static char const *const names[] = { "qt_Vertex", "qt_MultiTexCoord0", 0 };
+    return names;
+}
+
+void ContrastShader::initialize()
+{
+    m_matrixId = program()->uniformLocation("qt_Matrix");
+    m_opacityId = program()->uniformLocation("opacity");
+    m_colorMatrixId = program()->uniformLocation("colorMatrix");
+}
+
+void ContrastShader::updateState(const RenderState &state, QSGMaterial *newMaterial,
+                                 QSGMaterial *oldMaterial)
+{
+    ContrastMaterial *material = static_cast<ContrastMaterial *>(newMaterial);
+    ContrastMaterial *oldContrast = static_cast<ContrastMaterial *>(oldMaterial);
+
+    if (state.isMatrixDirty())
+        program()->setUniformValue(m_matrixId, state.combinedMatrix());
+    if (state.isOpacityDirty())
+        program()->setUniformValue(m_opacityId, state.opacity());
+
+    // Consecutive materials with the same parameters are common
+    if (!oldContrast || oldContrast->colorMatrix != material->colorMatrix)
+        program()->setUniformValue(m_colorMatrixId, material->colorMatrix);
+    material->texture->bind();
+}
+
+/*
+ * ContrastMaterial
+ */
+
+ContrastMaterial::ContrastMaterial()
+    : texture(Q_NULLPTR)
+{
+    setFlag(Blending);
+}
+
+QSGMaterialType *ContrastMaterial::type() const
+{
+    // One type means one program for all contrast regions
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader *ContrastMaterial::createShader() const
+{
+    return new ContrastShader;
+}
+
+int ContrastMaterial::compare(const QSGMaterial *other) const
+{
+    // Materials that compare equal are merged in the same batch
+    const ContrastMaterial *material = static_cast<const ContrastMaterial *>(other);
+    if (texture != material->texture)
+        return texture->textureId() - material->texture->textureId();
+    return memcmp(colorMatrix.constData(), material->colorMatrix.constData(),
+                  16 * sizeof(float));
+}
+
+/*
+ * ContrastRegion
+ */
+
+ContrastRegion::ContrastRegion(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+}
+
+QuickSurface *ContrastRegion::surface() const
+{
+    return m_surface;
+}
+
+void ContrastRegion::setSurface(QuickSurface *surface)
+{
+    if (m_surface == surface)
+        return;
+
+    if (m_surface)
+        disconnect(m_surface, SIGNAL(contrastChanged()), this, SLOT(update()));
+    m_surface = surface;
+    if (m_surface)
+        connect(m_surface, SIGNAL(contrastChanged()), this, SLOT(update()));
+
+    Q_EMIT surfaceChanged();
+    update();
+}
+
+QQuickItem *ContrastRegion::source() const
+{
+    return m_source;
+}
+
+void ContrastRegion::setSource(QQuickItem *source)
+{
+    if (m_source == source)
+        return;
+
+    m_source = source;
+    Q_EMIT sourceChanged();
+    update();
+}
+
+QRectF ContrastRegion::sourceRect() const
+{
+    return m_sourceRect;
+}
+
+void ContrastRegion::setSourceRect(const QRectF &rect)
+{
+    if (m_sourceRect == rect)
+        return;
+
+    m_sourceRect = rect;
+    Q_EMIT sourceRectChanged();
+    update();
+}
+
+QSGNode *ContrastRegion::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    QSGGeometryNode *node = static_cast<QSGGeometryNode *>(oldNode);
+
+    // Repaint when the source is rendered again
+    QSGTextureProvider *provider = Q_NULLPTR;
+    if (m_source && m_source->isTextureProvider())
+        provider = m_source->textureProvider();
+    if (provider != m_provider) {
+        if (m_provider)
+            disconnect(m_provider, SIGNAL(textureChanged()), this, SLOT(update()));
+        m_provider = provider;
+        if (m_provider)
+            connect(m_provider, SIGNAL(textureChanged()), this, SLOT(update()),
+                    Qt::QueuedConnection);
+    }
+
+    QSGTexture *texture = provider ? provider->texture() : Q_NULLPTR;
+    QVector<QRect> rects = m_surface ? m_surface->contrastRegion().rects() : QVector<QRect>();
+    if (!texture || rects.isEmpty() || m_sourceRect.isEmpty()) {
+        delete node;
+        return Q_NULLPTR;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+        node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+
+        QSGGeometry *geometry = new QSGGeometry(
+                    QSGGeometry::defaultAttributes_TexturedPoint2D(), 0);
+        geometry->setDrawingMode(GL_TRIANGLES);
+        node->setGeometry(geometry);
+        node->setMaterial(new ContrastMaterial);
+    }
+
+    ContrastMaterial *material = static_cast<ContrastMaterial *>(node->material());
+    texture->setFiltering(QSGTexture::Linear);
+    material->texture = texture;
+    material->colorMatrix = colorMatrix(m_surface->contrast(), m_surface->intensity(),
+                                        m_surface->saturation());
+
+    // Two triangles for each rectangle of the region, so
+    // that nothing outside of it is ever touched
+    QSGGeometry *geometry = node->geometry();
+    geometry->allocate(rects.size() * 6);
+    QSGGeometry::TexturedPoint2D *v = geometry->vertexDataAsTexturedPoint2D();
+    QRectF subRect = texture->normalizedTextureSubRect();
+    for (const QRect &rect: rects) {
+        QRectF r = QRectF(rect) & boundingRect();
+
+        qreal tx1 = subRect.x() + (r.left() - m_sourceRect.x()) / m_sourceRect.width() * subRect.width();
+        qreal tx2 = subRect.x() + (r.right() - m_sourceRect.x()) / m_sourceRect.width() * subRect.width();
+        qreal ty1 = subRect.y() + (r.top() - m_sourceRect.y()) / m_sourceRect.height() * subRect.height();
+        qreal ty2 = subRect.y() + (r.bottom() - m_sourceRect.y()) / m_sourceRect.height() * subRect.height();
+
+        v[0].set(r.left(), r.top(), tx1, ty1);
+        v[1].set(r.right(), r.top(), tx2, ty1);
+        v[2].set(r.left(), r.bottom(), tx1, ty2);
+        v[3].set(r.left(), r.bottom(), tx1, ty2);
+        v[4].set(r.right(), r.top(), tx2, ty1);
+        v[5].set(r.right(), r.bottom(), tx2, ty2);
+        v += 6;
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry | QSGNode::DirtyMaterial);
+    return node;
+}
+
+#include "moc_contrastregion.cpp"
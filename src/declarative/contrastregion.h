@@ -0,0 +1,74 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:LGPL2.1+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef CONTRASTREGION_H
+#define CONTRASTREGION_H
+
+#include <QtCore/QPointer>
+#include <QtQuick/QQuickItem>
+
+class QSGTextureProvider;
+
+namespace GreenIsland {
+class QuickSurface;
+}
+
+class ContrastRegion : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(GreenIsland::QuickSurface *surface READ surface WRITE setSurface NOTIFY surfaceChanged)
+    Q_PROPERTY(QQuickItem *source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QRectF sourceRect READ sourceRect WRITE setSourceRect NOTIFY sourceRectChanged)
+public:
+    explicit ContrastRegion(QQuickItem *parent = 0);
+
+    GreenIsland::QuickSurface *surface() const;
+    void setSurface(GreenIsland::QuickSurface *surface);
+
+    // Texture provider with what's behind the surface
+    QQuickItem *source() const;
+    void setSource(QQuickItem *source);
+
+    // Where the source texture is, in item coordinates
+    QRectF sourceRect() const;
+    void setSourceRect(const QRectF &rect);
+
+Q_SIGNALS:
+    void surfaceChanged();
+    void sourceChanged();
+    void sourceRectChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) Q_DECL_OVERRIDE;
+
+private:
+    QPointer<GreenIsland::QuickSurface> m_surface;
+    QPointer<QQuickItem> m_source;
+    QPointer<QSGTextureProvider> m_provider;
+    QRectF m_sourceRect;
+};
+
+#endif // CONTRASTREGION_H
@@ -28,13 +28,19 @@
 #include <QtQml/QQmlComponent>
 
 #include <GreenIsland/ClientWindow>
+#include <GreenIsland/ClientWindowModel>
 #include <GreenIsland/Compositor>
 #include <GreenIsland/Output>
 #include <GreenIsland/QuickSurface>
+#include <GreenIsland/SurfaceModel>
 #include <GreenIsland/WindowView>
 #include <GreenIsland/ShellWindowView>
+#include <GreenIsland/WorkspaceManager>
 
+#include "contrastregion.h"
 #include "fpscounter.h"
+#include "windowlayout.h"
+#include "windowthumbnail.h"
 
 using namespace GreenIsland;
 
@@ -58,7 +64,16 @@ void GreenIslandPlugin::registerTypes(const char *uri)
                                            QStringLiteral("You can't create WindowView objects"));
     qmlRegisterUncreatableType<ShellWindowView>(uri, 1, 0, "ShellWindowView",
                                                 QStringLiteral("You can't create ShellWindowView objects"));
+    qmlRegisterUncreatableType<ClientWindowModel>(uri, 1, 0, "ClientWindowModel",
+                                                  QStringLiteral("You can't create ClientWindowModel objects"));
+    qmlRegisterUncreatableType<SurfaceModel>(uri, 1, 0, "SurfaceModel",
+                                             QStringLiteral("You can't create SurfaceModel objects"));
+    qmlRegisterUncreatableType<WorkspaceManager>(uri, 1, 0, "WorkspaceManager",
+                                                 QStringLiteral("You can't create WorkspaceManager objects"));
+    qmlRegisterType<ContrastRegion>(uri, 1, 0, "ContrastRegion");
     qmlRegisterType<FpsCounter>(uri, 1, 0, "FpsCounter");
+    qmlRegisterType<WindowLayout>(uri, 1, 0, "WindowLayout");
+    qmlRegisterType<WindowThumbnail>(uri, 1, 0, "WindowThumbnail");
 }
 
 #include "plugin.moc"
@@ -0,0 +1,221 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:LGPL2.1+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include <QtCore/QtMath>
+#include <QtCore/QVector>
+
+#include "windowlayout.h"
+
+// Natural layout gives up after this many passes, what's still
+// overlapping by then is left to the final scaling
+static const int s_maxNaturalPasses = 100;
+
+static QRectF fitInto(const QRectF &geometry, const QRectF &cell)
+{
+    // Shrink keeping the aspect ratio, centered in the cell
+    qreal scale = qMin(1.0, qMin(cell.width() / geometry.width(),
+                                 cell.height() / geometry.height()));
+    QSizeF size = geometry.size() * scale;
+    return QRectF(cell.center() - QPointF(size.width() / 2, size.height() / 2), size);
+}
+
+WindowLayout::WindowLayout(QObject *parent)
+    : QObject(parent)
+    , m_mode(Natural)
+    , m_spacing(20)
+{
+}
+
+WindowLayout::Mode WindowLayout::mode() const
+{
+    return m_mode;
+}
+
+void WindowLayout::setMode(Mode mode)
+{
+    if (m_mode == mode)
+        return;
+
+    m_mode = mode;
+    Q_EMIT modeChanged();
+}
+
+qreal WindowLayout::spacing() const
+{
+    return m_spacing;
+}
+
+void WindowLayout::setSpacing(qreal spacing)
+{
+    if (m_spacing == spacing)
+        return;
+
+    m_spacing = spacing;
+    Q_EMIT spacingChanged();
+}
+
+QVariantList WindowLayout::arrange(const QVariantList &geometries,
+                                   const QRectF &area) const
+{
+    QList<QRectF> rects;
+    rects.reserve(geometries.size());
+    for (const QVariant &geometry: geometries)
+        rects.append(geometry.toRectF());
+
+    QVariantList result;
+    result.reserve(rects.size());
+    for (const QRectF &rect: arrange(rects, area))
+        result.append(rect);
+    return result;
+}
+
+QList<QRectF> WindowLayout::arrange(const QList<QRectF> &geometries,
+                                    const QRectF &area) const
+{
+    if (geometries.isEmpty() || area.isEmpty())
+        return geometries;
+
+    if (m_mode == Grid)
+        return gridLayout(geometries, area);
+    return naturalLayout(geometries, area);
+}
+
+QList<QRectF> WindowLayout::gridLayout(const QList<QRectF> &geometries,
+                                       const QRectF &area) const
+{
+    const int count = geometries.size();
+    const int columns = qCeil(qSqrt(count));
+    const int rows = qCeil(qreal(count) / columns);
+    const qreal cellWidth = area.width() / columns;
+    const qreal cellHeight = area.height() / rows;
+
+    // Fill cells in reading order of the current positions, so
+    // that windows move as little as possible
+    QVector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        QPointF ca = geometries.at(a).center();
+        QPointF cb = geometries.at(b).center();
+        int rowA = qBound(0, int((ca.y() - area.top()) / cellHeight), rows - 1);
+        int rowB = qBound(0, int((cb.y() - area.top()) / cellHeight), rows - 1);
+        if (rowA != rowB)
+            return rowA < rowB;
+        return ca.x() < cb.x();
+    });
+
+    QList<QRectF> result = geometries;
+    for (int i = 0; i < count; ++i) {
+        QRectF cell(area.left() + (i % columns) * cellWidth,
+                    area.top() + (i / columns) * cellHeight,
+                    cellWidth, cellHeight);
+        cell.adjust(m_spacing / 2, m_spacing / 2, -m_spacing / 2, -m_spacing / 2);
+
+        int index = order.at(i);
+        if (!geometries.at(index).isEmpty() && !cell.isEmpty())
+            result[index] = fitInto(geometries.at(index), cell);
+    }
+    return result;
+}
+
+QList<QRectF> WindowLayout::naturalLayout(const QList<QRectF> &geometries,
+                                          const QRectF &area) const
+{
+    const int count = geometries.size();
+    const qreal halfSpacing = m_spacing / 2;
+
+    // Work with spacing included, it's removed at the end
+    QVector<QRectF> rects(count);
+    for (int i = 0; i < count; ++i)
+        rects[i] = geometries.at(i).adjusted(-halfSpacing, -halfSpacing,
+                                             halfSpacing, halfSpacing);
+
+    // Push overlapping windows apart along the axis with the smallest
+    // overlap, each by half of it, until nothing overlaps
+    QVector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+
+    for (int pass = 0; pass < s_maxNaturalPasses; ++pass) {
+        bool overlap = false;
+
+        // Sweep from left to right, only windows starting before the
+        // current one ends can overlap with it
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return rects.at(a).left() < rects.at(b).left();
+        });
+
+        for (int m = 0; m < count; ++m) {
+            int i = order.at(m);
+
+            for (int n = m + 1; n < count; ++n) {
+                int j = order.at(n);
+                if (rects.at(j).left() >= rects.at(i).right())
+                    break;
+
+                QRectF intersection = rects.at(i) & rects.at(j);
+                if (intersection.isEmpty())
+                    continue;
+                overlap = true;
+
+                QPointF diff = rects.at(j).center() - rects.at(i).center();
+                if (intersection.width() < intersection.height()) {
+                    qreal dx = (intersection.width() / 2 + 1) * (diff.x() < 0 ? -1 : 1);
+                    rects[i].translate(-dx, 0);
+                    rects[j].translate(dx, 0);
+                } else {
+                    qreal dy = (intersection.height() / 2 + 1) * (diff.y() < 0 ? -1 : 1);
+                    rects[i].translate(0, -dy);
+                    rects[j].translate(0, dy);
+                }
+            }
+        }
+
+        if (!overlap)
+            break;
+    }
+
+    // Scale everything into the area
+    QRectF bounds;
+    for (const QRectF &rect: rects)
+        bounds |= rect;
+    qreal scale = qMin(1.0, qMin(area.width() / bounds.width(),
+                                 area.height() / bounds.height()));
+    QPointF offset = area.center() - bounds.center() * scale;
+
+    QList<QRectF> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QRectF rect = rects.at(i).adjusted(halfSpacing, halfSpacing,
+                                           -halfSpacing, -halfSpacing);
+        result.append(QRectF(rect.topLeft() * scale + offset, rect.size() * scale));
+    }
+    return result;
+}
+
+#include "moc_windowlayout.cpp"
@@ -0,0 +1,79 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:LGPL2.1+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef WINDOWLAYOUT_H
+#define WINDOWLAYOUT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QRectF>
+#include <QtCore/QVariantList>
+
+class WindowLayout : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(Mode mode READ mode WRITE setMode NOTIFY modeChanged)
+    Q_PROPERTY(qreal spacing READ spacing WRITE setSpacing NOTIFY spacingChanged)
+    Q_ENUMS(Mode)
+public:
+    enum Mode {
+        //! Windows are arranged in rows and columns of equal size.
+        Grid,
+        //! Windows keep their relative positions and are moved
+        //! as little as possible to not overlap.
+        Natural
+    };
+
+    explicit WindowLayout(QObject *parent = 0);
+
+    Mode mode() const;
+    void setMode(Mode mode);
+
+    qreal spacing() const;
+    void setSpacing(qreal spacing);
+
+    // Returns the target geometry of each window, in the same order,
+    // scaled to fit the area without ever making windows bigger
+    Q_INVOKABLE QVariantList arrange(const QVariantList &geometries,
+                                     const QRectF &area) const;
+
+    QList<QRectF> arrange(const QList<QRectF> &geometries,
+                          const QRectF &area) const;
+
+Q_SIGNALS:
+    void modeChanged();
+    void spacingChanged();
+
+private:
+    Mode m_mode;
+    qreal m_spacing;
+
+    QList<QRectF> gridLayout(const QList<QRectF> &geometries,
+                             const QRectF &area) const;
+    QList<QRectF> naturalLayout(const QList<QRectF> &geometries,
+                                const QRectF &area) const;
+};
+
+#endif // WINDOWLAYOUT_H
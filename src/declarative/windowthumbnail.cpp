@@ -0,0 +1,437 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:LGPL2.1+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLShaderProgram>
+#include <QtGui/QVector2D>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGTextureMaterial>
+#include <QtQuick/QSGTextureProvider>
+#include <QtCompositor/QWaylandSurfaceItem>
+
+#include <GreenIsland/QuickSurface>
+
+#include "windowthumbnail.h"
+
+/*
+ * WindowThumbnailProvider
+ */
+
+class WindowThumbnailProvider : public QSGTextureProvider
+{
+public:
+    WindowThumbnailProvider()
+        : QSGTextureProvider()
+        , m_texture(Q_NULLPTR)
+    {
+    }
+
+    QSGTexture *texture() const Q_DECL_OVERRIDE
+    {
+        return m_texture;
+    }
+
+    void setTexture(QSGTexture *texture)
+    {
+        m_texture = texture;
+        Q_EMIT textureChanged();
+    }
+
+private:
+    QSGTexture *m_texture;
+};
+
+/*
+ * WindowThumbnailNode
+ */
+
+class WindowThumbnailNode : public QSGGeometryNode
+{
+public:
+    WindowThumbnailNode(QQuickWindow *window, WindowThumbnailProvider *provider);
+    ~WindowThumbnailNode();
+
+    void setSource(QSGTexture *source, bool yInverted, const QSize &targetSize);
+    void setSnapshot(QSGTexture *snapshot);
+    void setRect(const QRectF &rect);
+
+    void preprocess() Q_DECL_OVERRIDE;
+
+private:
+    QQuickWindow *m_window;
+    QPointer<WindowThumbnailProvider> m_provider;
+    QSGGeometry m_geometry;
+    QSGTextureMaterial m_material;
+    QOpenGLShaderProgram *m_program;
+    QOpenGLFramebufferObject *m_fbo;
+    QSGTexture *m_texture;
+    QSGTexture *m_source;
+    QSGTexture *m_snapshot;
+    bool m_yInverted;
+    QSize m_targetSize;
+    bool m_dirty;
+
+    void copy();
+};
+
+WindowThumbnailNode::WindowThumbnailNode(QQuickWindow *window, WindowThumbnailProvider *provider)
+    : QSGGeometryNode()
+    , m_window(window)
+    , m_provider(provider)
+    , m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4)
+    , m_program(Q_NULLPTR)
+    , m_fbo(Q_NULLPTR)
+    , m_texture(Q_NULLPTR)
+    , m_source(Q_NULLPTR)
+    , m_snapshot(Q_NULLPTR)
+    , m_yInverted(false)
+    , m_dirty(false)
+{
+    setFlag(QSGNode::UsePreprocess);
+    setGeometry(&m_geometry);
+    setMaterial(&m_material);
+
+    // Mipmaps keep small thumbnails from aliasing
+    m_material.setFiltering(QSGTexture::Linear);
+    m_material.setMipmapFiltering(QSGTexture::Linear);
+}
+
+WindowThumbnailNode::~WindowThumbnailNode()
+{
+    if (m_provider)
+        m_provider->setTexture(Q_NULLPTR);
+    delete m_texture;
+    delete m_snapshot;
+    delete m_fbo;
+    delete m_program;
+}
+
+void WindowThumbnailNode::setSource(QSGTexture *source, bool yInverted, const QSize &targetSize)
+{
+    m_source = source;
+    m_yInverted = yInverted;
+    m_targetSize = targetSize;
+    m_dirty = true;
+    markDirty(QSGNode::DirtyMaterial);
+}
+
+void WindowThumbnailNode::setSnapshot(QSGTexture *snapshot)
+{
+    // Texture made from the snapshot of an evicted surface,
+    // owned by the node until the source changes again
+    if (m_snapshot != snapshot)
+        delete m_snapshot;
+    m_snapshot = snapshot;
+}
+
+void WindowThumbnailNode::setRect(const QRectF &rect)
+{
+    QSGGeometry::updateTexturedRectGeometry(&m_geometry, rect, QRectF(0, 0, 1, 1));
+    markDirty(QSGNode::DirtyGeometry);
+}
+
+void WindowThumbnailNode::preprocess()
+{
+    // Copy after all items were synchronized, when
+    // the surface texture is up to date
+    if (m_dirty && m_source) {
+        m_dirty = false;
+        copy();
+    }
+}
+
+void WindowThumbnailNode::copy()
+{
+    QSize sourceSize = m_source->textureSize();
+    if (sourceSize.isEmpty() || m_targetSize.isEmpty())
+        return;
+
+    // Halve the copy while it's bigger than twice the thumbnail,
+    // mipmaps take care of the remaining scale factor
+    QSize size = sourceSize;
+    int factor = 1;
+    while (size.width() / 2 >= m_targetSize.width() &&
+           size.height() / 2 >= m_targetSize.height()) {
+        size /= 2;
+        factor *= 2;
+    }
+
+    if (!m_fbo || m_fbo->size() != size) {
+        delete m_texture;
+        delete m_fbo;
+
+        QOpenGLFramebufferObjectFormat format;
+        format.setMipmap(true);
+        format.setInternalTextureFormat(GL_RGBA);
+        m_fbo = new QOpenGLFramebufferObject(size, format);
+        m_texture = m_window->createTextureFromId(
+                    m_fbo->texture(), size,
+                    QQuickWindow::CreateTextureOptions(QQuickWindow::TextureHasAlphaChannel |
+                                                       QQuickWindow::TextureHasMipmaps));
+        m_texture->setFiltering(QSGTexture::Linear);
+        m_texture->setMipmapFiltering(QSGTexture::Linear);
+        m_material.setTexture(m_texture);
+    }
+
+    if (!m_program) {
+        m_program = new QOpenGLShaderProgram;
+        m_program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+            "attribute highp vec4 vertex;\n"
+            "attribute highp vec2 texCoord;\n"
+            "varying highp vec2 coord;\n"
+            "void main() {\n"
+            "    coord = texCoord;\n"
+            "    gl_Position = vertex;\n"
+            "}\n");
+        m_program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+            "uniform sampler2D source;\n"
+            "uniform highp vec2 offset;\n"
+            "varying highp vec2 coord;\n"
+            "void main() {\n"
+            "    gl_FragColor = 0.25 * (texture2D(source, coord + offset) +\n"
+            "                           texture2D(source, coord - offset) +\n"
+            "                           texture2D(source, coord + vec2(offset.x, -offset.y)) +\n"
+            "                           texture2D(source, coord - vec2(offset.x, -offset.y)));\n"
+            "}\n");
+        m_program->bindAttributeLocation("vertex", 0);
+        m_program->bindAttributeLocation("texCoord", 1);
+        m_program->link();
+    }
+
+    // The first row of the copy is the top of the window, like
+    // any other scene graph texture
+    const GLfloat top = m_yInverted ? 0.0f : 1.0f;
+    const GLfloat bottom = 1.0f - top;
+    const GLfloat vertices[] = { -1, -1, 1, -1, -1, 1, 1, 1 };
+    const GLfloat texCoords[] = { 0, top, 1, top, 0, bottom, 1, bottom };
+
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    m_fbo->bind();
+    gl->glViewport(0, 0, size.width(), size.height());
+    gl->glDisable(GL_BLEND);
+    gl->glDisable(GL_DEPTH_TEST);
+    gl->glDisable(GL_SCISSOR_TEST);
+    gl->glDisable(GL_STENCIL_TEST);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_program->bind();
+    m_program->setUniformValue("source", 0);
+    m_program->setUniformValue("offset", QVector2D(0.25f * factor / sourceSize.width(),
+                                                   0.25f * factor / sourceSize.height()));
+    m_program->enableAttributeArray(0);
+    m_program->enableAttributeArray(1);
+    m_program->setAttributeArray(0, GL_FLOAT, vertices, 2);
+    m_program->setAttributeArray(1, GL_FLOAT, texCoords, 2);
+
+    gl->glActiveTexture(GL_TEXTURE0);
+    m_source->setFiltering(QSGTexture::Linear);
+    m_source->bind();
+    gl->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    m_program->disableAttributeArray(0);
+    m_program->disableAttributeArray(1);
+    m_program->release();
+    m_fbo->release();
+
+    gl->glBindTexture(GL_TEXTURE_2D, m_fbo->texture());
+    gl->glGenerateMipmap(GL_TEXTURE_2D);
+
+    markDirty(QSGNode::DirtyMaterial);
+    if (m_provider)
+        m_provider->setTexture(m_texture);
+}
+
+/*
+ * WindowThumbnail
+ */
+
+WindowThumbnail::WindowThumbnail(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_maximumRate(10)
+    , m_dirty(false)
+    , m_pending(false)
+    , m_provider(Q_NULLPTR)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    m_refreshTimer.setSingleShot(true);
+    connect(&m_refreshTimer, SIGNAL(timeout()),
+            this, SLOT(refreshTimeout()));
+}
+
+WindowThumbnail::~WindowThumbnail()
+{
+    // Lives on the render thread
+    if (m_provider)
+        m_provider->deleteLater();
+}
+
+QQuickItem *WindowThumbnail::source() const
+{
+    return m_source;
+}
+
+void WindowThumbnail::setSource(QQuickItem *source)
+{
+    if (m_source == source)
+        return;
+
+    QWaylandSurfaceItem *surfaceItem = qobject_cast<QWaylandSurfaceItem *>(m_source);
+    if (surfaceItem && surfaceItem->surface()) {
+        disconnect(surfaceItem->surface(), SIGNAL(damaged(QRegion)),
+                   this, SLOT(refresh()));
+        disconnect(surfaceItem->surface(), SIGNAL(textureEvictedChanged()),
+                   this, SLOT(refresh()));
+    }
+
+    m_source = source;
+
+    // Copy again only when the client commits or
+    // when the texture is uploaded after eviction
+    surfaceItem = qobject_cast<QWaylandSurfaceItem *>(m_source);
+    if (surfaceItem && surfaceItem->surface()) {
+        connect(surfaceItem->surface(), SIGNAL(damaged(QRegion)),
+                this, SLOT(refresh()));
+        connect(surfaceItem->surface(), SIGNAL(textureEvictedChanged()),
+                this, SLOT(refresh()));
+    }
+
+    Q_EMIT sourceChanged();
+    refresh();
+}
+
+int WindowThumbnail::maximumRate() const
+{
+    return m_maximumRate;
+}
+
+void WindowThumbnail::setMaximumRate(int rate)
+{
+    if (m_maximumRate == rate)
+        return;
+
+    m_maximumRate = qMax(1, rate);
+    Q_EMIT maximumRateChanged();
+}
+
+bool WindowThumbnail::isTextureProvider() const
+{
+    return true;
+}
+
+QSGTextureProvider *WindowThumbnail::textureProvider() const
+{
+    if (!m_provider)
+        m_provider = new WindowThumbnailProvider;
+    return m_provider;
+}
+
+void WindowThumbnail::refresh()
+{
+    // Too early, refresh when the interval is elapsed
+    int interval = 1000 / m_maximumRate;
+    if (m_lastRefresh.isValid() && m_lastRefresh.elapsed() < interval) {
+        m_pending = true;
+        if (!m_refreshTimer.isActive())
+            m_refreshTimer.start(interval - m_lastRefresh.elapsed());
+        return;
+    }
+
+    m_pending = false;
+    m_dirty = true;
+    m_lastRefresh.start();
+    update();
+}
+
+void WindowThumbnail::refreshTimeout()
+{
+    if (m_pending)
+        refresh();
+}
+
+QSGNode *WindowThumbnail::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    WindowThumbnailNode *node = static_cast<WindowThumbnailNode *>(oldNode);
+
+    QSGTextureProvider *provider = Q_NULLPTR;
+    if (m_source && m_source->isTextureProvider())
+        provider = m_source->textureProvider();
+    QSGTexture *texture = provider ? provider->texture() : Q_NULLPTR;
+    if (texture && texture->textureSize().isEmpty())
+        texture = Q_NULLPTR;
+
+    // Surfaces whose texture was evicted keep the last copy,
+    // or show their snapshot when there's none
+    QSGTexture *snapshot = Q_NULLPTR;
+    QWaylandSurfaceItem *surfaceItem = qobject_cast<QWaylandSurfaceItem *>(m_source);
+    GreenIsland::QuickSurface *surface = surfaceItem ?
+                qobject_cast<GreenIsland::QuickSurface *>(surfaceItem->surface()) : Q_NULLPTR;
+    if (!texture && surface && surface->isTextureEvicted()) {
+        if (node && width() > 0 && height() > 0) {
+            node->setRect(boundingRect());
+            return node;
+        }
+
+        QImage image = surface->snapshot();
+        if (!image.isNull()) {
+            snapshot = window()->createTextureFromImage(image);
+            texture = snapshot;
+        }
+    }
+
+    if (!texture || width() <= 0 || height() <= 0) {
+        delete snapshot;
+        delete node;
+        return Q_NULLPTR;
+    }
+
+    if (!node) {
+        textureProvider();
+        node = new WindowThumbnailNode(window(), m_provider);
+        m_dirty = true;
+    }
+
+    node->setRect(boundingRect());
+
+    if (m_dirty) {
+        m_dirty = false;
+
+        // Scaled ancestors make the thumbnail smaller on screen
+        QSizeF size = mapRectToScene(boundingRect()).size() * window()->devicePixelRatio();
+        node->setSource(texture, m_source->property("isYInverted").toBool(),
+                        size.toSize().expandedTo(QSize(1, 1)));
+        node->setSnapshot(snapshot);
+    }
+
+    return node;
+}
+
+#include "moc_windowthumbnail.cpp"
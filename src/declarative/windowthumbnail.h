@@ -0,0 +1,81 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:LGPL2.1+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef WINDOWTHUMBNAIL_H
+#define WINDOWTHUMBNAIL_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtQuick/QQuickItem>
+
+class WindowThumbnailProvider;
+
+class WindowThumbnail : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QQuickItem *source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(int maximumRate READ maximumRate WRITE setMaximumRate NOTIFY maximumRateChanged)
+public:
+    explicit WindowThumbnail(QQuickItem *parent = 0);
+    ~WindowThumbnail();
+
+    // Surface item whose texture is copied
+    QQuickItem *source() const;
+    void setSource(QQuickItem *source);
+
+    // How many times per second the copy can be refreshed
+    int maximumRate() const;
+    void setMaximumRate(int rate);
+
+    bool isTextureProvider() const Q_DECL_OVERRIDE;
+    QSGTextureProvider *textureProvider() const Q_DECL_OVERRIDE;
+
+public Q_SLOTS:
+    // Copy the source again, as soon as the rate allows
+    void refresh();
+
+Q_SIGNALS:
+    void sourceChanged();
+    void maximumRateChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void refreshTimeout();
+
+private:
+    QPointer<QQuickItem> m_source;
+    int m_maximumRate;
+    bool m_dirty;
+    bool m_pending;
+    QElapsedTimer m_lastRefresh;
+    QTimer m_refreshTimer;
+    mutable WindowThumbnailProvider *m_provider;
+};
+
+#endif // WINDOWTHUMBNAIL_H
@@ -59,6 +59,12 @@ int main(int argc, char *argv[])
                                     QStringLiteral("plugin"));
     parser.addOption(pluginOption);
 
+    // Startup benchmark
+    QCommandLineOption benchmarkOption(QStringLiteral("benchmark"),
+                                       TR("Start the compositor the given number of times and report the startup time"),
+                                       QStringLiteral("runs"));
+    parser.addOption(benchmarkOption);
+
     // Parse command line
     parser.process(app);
 
@@ -70,6 +76,8 @@ int main(int argc, char *argv[])
 
     // Pass additional arguments
     processController.setPlugin(parser.value(pluginOption));
+    if (parser.isSet(benchmarkOption))
+        processController.setBenchmarkRuns(parser.value(benchmarkOption).toInt());
 
     // Start the compositor
     processController.start();
@@ -26,6 +26,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtCore/QFileSystemWatcher>
 
@@ -38,6 +39,7 @@
 ProcessController::ProcessController(QObject *parent)
     : QObject(parent)
     , m_fullScreenShell(Q_NULLPTR)
+    , m_benchmarkRuns(0)
 {
     // Compositor process
     m_compositor = new QProcess(this);
@@ -48,7 +50,14 @@ ProcessController::ProcessController(QObject *parent)
         qWarning() << qPrintable(m_compositor->readAllStandardError());
     });
     connect(m_compositor, &QProcess::readyReadStandardOutput, [=]() {
-        qDebug() << qPrintable(m_compositor->readAllStandardOutput());
+        // Lines may be split across reads, keep what's left of
+        // the last one until its newline arrives
+        m_compositorOutput.append(m_compositor->readAllStandardOutput());
+        int newline;
+        while ((newline = m_compositorOutput.indexOf('\n')) >= 0) {
+            processOutputLine(m_compositorOutput.left(newline));
+            m_compositorOutput.remove(0, newline + 1);
+        }
     });
 
     // Wayland sockets
@@ -96,8 +105,22 @@ void ProcessController::setPlugin(const QString &plugin)
     m_plugin = plugin;
 }
 
+int ProcessController::benchmarkRuns() const
+{
+    return m_benchmarkRuns;
+}
+
+void ProcessController::setBenchmarkRuns(int runs)
+{
+    m_benchmarkRuns = runs;
+}
+
 void ProcessController::start()
 {
+    // Startup phases are recorded for each run
+    m_startupPhases.clear();
+    markStartupPhase(QStringLiteral("launcher-start"));
+
     // Run the full screen shell compositor if enabled
     if (m_fullScreenShell) {
         qDebug() << "Running:" << qPrintable(m_fullScreenShell->program())
@@ -106,6 +129,7 @@ void ProcessController::start()
 
         if (!m_fullScreenShell->waitForStarted())
             qFatal("Full Screen Shell compositor cannot be started, aborting...");
+        markStartupPhase(QStringLiteral("fullscreen-shell-started"));
 
         return;
     }
@@ -132,6 +156,45 @@ QString ProcessController::randomString() const
     return randomString;
 }
 
+void ProcessController::processOutputLine(const QByteArray &data)
+{
+    // Collect startup time when benchmarking, print anything else
+    const QByteArray line = data.trimmed();
+    if (m_benchmarkRuns > 0 && line.startsWith("greenisland-startup-time "))
+        m_benchmarkResults.append(line.mid(25).toLongLong());
+    else
+        qDebug() << qPrintable(line);
+}
+
+void ProcessController::markStartupPhase(const QString &phase)
+{
+    // Use the monotonic clock like the compositor does, so that
+    // it can tell how long each phase took
+    QElapsedTimer timer;
+    timer.start();
+    m_startupPhases.append(QStringLiteral("%1=%2").arg(phase).arg(timer.msecsSinceReference()));
+}
+
+void ProcessController::printBenchmarkResults()
+{
+    if (m_benchmarkResults.isEmpty()) {
+        qWarning() << "No startup time was collected";
+        return;
+    }
+
+    qint64 min = m_benchmarkResults.first();
+    qint64 max = min;
+    qint64 sum = 0;
+    for (qint64 result: m_benchmarkResults) {
+        min = qMin(min, result);
+        max = qMax(max, result);
+        sum += result;
+    }
+
+    qDebug("Startup time to first frame over %d runs: min %lld ms, avg %lld ms, max %lld ms",
+           m_benchmarkResults.size(), min, sum / m_benchmarkResults.size(), max);
+}
+
 void ProcessController::detect()
 {
     // No need to detect anything if full screen shell is forced
@@ -155,6 +218,9 @@ void ProcessController::startCompositor()
     // Detect the environment
     detect();
 
+    // Environment
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+
     // Pass arguments for full screen shell
     if (isFullScreenShellEnabled()) {
         m_compositor->setArguments(QStringList()
@@ -165,13 +231,19 @@ void ProcessController::startCompositor()
             m_compositor->setArguments(m_compositor->arguments()
                                        << QStringLiteral("-p") << m_plugin);
 
-        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
         env.insert(QStringLiteral("WAYLAND_DISPLAY"), m_fullScreenShellSocket);
         if (qEnvironmentVariableIsSet("DISPLAY") && !isFullScreenShellEnabled())
             env.insert(QStringLiteral("QT_XCB_GL_INTEGRATION"), QStringLiteral("xcb_egl"));
-        m_compositor->setProcessEnvironment(env);
     }
 
+    // Pass startup phases recorded so far to the compositor,
+    // which will report them together with its own
+    markStartupPhase(QStringLiteral("compositor-spawn"));
+    env.insert(QStringLiteral("GREENISLAND_STARTUP_PHASES"), m_startupPhases.join(QLatin1Char(';')));
+    if (m_benchmarkRuns > 0)
+        env.insert(QStringLiteral("GREENISLAND_STARTUP_BENCHMARK"), QStringLiteral("1"));
+    m_compositor->setProcessEnvironment(env);
+
     // Start the process
     qDebug() << "Running:" << qPrintable(m_compositor->program())
              << qPrintable(m_compositor->arguments().join(" "));
@@ -198,6 +270,7 @@ void ProcessController::directoryChanged(const QString &path)
     // called over and over again
     m_fullScreenShellWatcher->disconnect(this);
     m_fullScreenShellWatcher->deleteLater();
+    markStartupPhase(QStringLiteral("fullscreen-shell-socket"));
     startCompositor();
 }
 
@@ -208,8 +281,19 @@ void ProcessController::compositorFinished(int code, const QProcess::ExitStatus
     if (code != 0)
         qWarning() << "Compositor finished with exit code" << code;
 
+    // Last line might not end with a newline
+    m_compositorOutput.append(m_compositor->readAllStandardOutput());
+    if (!m_compositorOutput.isEmpty()) {
+        for (const QByteArray &line: m_compositorOutput.split('\n')) {
+            if (!line.isEmpty())
+                processOutputLine(line);
+        }
+        m_compositorOutput.clear();
+    }
+
     // Whathever the reason why it finished is we need to quit the
     // full screen shell compositor, if any
+    bool nested = m_fullScreenShell != Q_NULLPTR;
     if (m_fullScreenShell) {
         m_fullScreenShell->terminate();
         if (!m_fullScreenShell->waitForFinished())
@@ -218,6 +302,19 @@ void ProcessController::compositorFinished(int code, const QProcess::ExitStatus
         m_fullScreenShell = Q_NULLPTR;
     }
 
+    // Cold start again until we have enough samples
+    if (m_benchmarkRuns > 0) {
+        if (code == 0 && m_benchmarkResults.size() < m_benchmarkRuns) {
+            qDebug() << "Benchmark run" << m_benchmarkResults.size() + 1
+                     << "of" << m_benchmarkRuns;
+            setFullScreenShellEnabled(nested);
+            start();
+            return;
+        }
+
+        printBenchmarkResults();
+    }
+
     // Quit
     qApp->quit();
 }
@@ -44,12 +44,16 @@ public:
     QString plugin() const;
     void setPlugin(const QString &plugin);
 
+    int benchmarkRuns() const;
+    void setBenchmarkRuns(int runs);
+
     void start();
 
 private:
     QProcess *m_compositor;
     QStringList m_compositorArgs;
     QString m_compositorSocket;
+    QByteArray m_compositorOutput;
 
     QProcess *m_fullScreenShell;
     QStringList m_fullScreenShellArgs;
@@ -58,8 +62,17 @@ private:
 
     QString m_plugin;
 
+    // Startup time measurement
+    QStringList m_startupPhases;
+    int m_benchmarkRuns;
+    QList<qint64> m_benchmarkResults;
+
     QString randomString() const;
 
+    void processOutputLine(const QByteArray &data);
+    void markStartupPhase(const QString &phase);
+    void printBenchmarkResults();
+
 private Q_SLOTS:
     void detect();
 
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtGui/QRegion>
+
+#include "blurdamagetracker.h"
+#include "compositor.h"
+#include "output.h"
+#include "outputlayout.h"
+#include "quicksurface.h"
+
+namespace GreenIsland {
+
+/*
+ * BlurDamageTrackerPrivate
+ */
+
+class BlurDamageTrackerPrivate
+{
+public:
+    BlurDamageTrackerPrivate(BlurDamageTracker *self);
+
+    QRegion globalBlurRegion(QuickSurface *surface) const;
+    void updateBlurSurface(QuickSurface *surface);
+    void addDamage(const QRegion &region);
+
+    void _q_surfaceDamaged(const QRegion &region);
+    void _q_surfaceGeometryChanged();
+    void _q_surfaceMappedChanged();
+    void _q_blurRegionChanged();
+    void _q_flush();
+
+    Compositor *compositor;
+
+    // Mapped surfaces asking for blur or contrast behind
+    QSet<QuickSurface *> blurSurfaces;
+
+    // Last known global geometry of mapped surfaces, moving
+    // a window damages both the old and the new area
+    QHash<QuickSurface *, QRect> geometries;
+
+    // Global damage accumulated since the last flush
+    QRegion damage;
+    QTimer *flushTimer;
+
+private:
+    Q_DECLARE_PUBLIC(BlurDamageTracker)
+    BlurDamageTracker *const q_ptr;
+};
+
+BlurDamageTrackerPrivate::BlurDamageTrackerPrivate(BlurDamageTracker *self)
+    : compositor(Q_NULLPTR)
+    , q_ptr(self)
+{
+    flushTimer = new QTimer(self);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(0);
+    self->connect(flushTimer, SIGNAL(timeout()),
+                  self, SLOT(_q_flush()));
+}
+
+QRegion BlurDamageTrackerPrivate::globalBlurRegion(QuickSurface *surface) const
+{
+    // Contrast regions show the same copy of what's behind
+    QRegion region = surface->blurRegion() + surface->contrastRegion();
+    return region.translated(surface->globalPosition().toPoint());
+}
+
+void BlurDamageTrackerPrivate::updateBlurSurface(QuickSurface *surface)
+{
+    bool blur = surface->isMapped() &&
+            (surface->hasBlurBehind() || surface->hasContrastBehind());
+    if (blur)
+        blurSurfaces.insert(surface);
+    else
+        blurSurfaces.remove(surface);
+
+    // The cached copy might be stale where blur is shown now
+    // because damage outside blur regions is not tracked
+    if (blur)
+        addDamage(globalBlurRegion(surface));
+    else
+        flushTimer->start();
+}
+
+void BlurDamageTrackerPrivate::addDamage(const QRegion &region)
+{
+    // Nobody is interested in damage without blur regions
+    if (blurSurfaces.isEmpty() || region.isEmpty())
+        return;
+
+    damage += region;
+    flushTimer->start();
+}
+
+void BlurDamageTrackerPrivate::_q_surfaceDamaged(const QRegion &region)
+{
+    Q_Q(BlurDamageTracker);
+
+    // Surfaces with blur behind are drawn on top of the
+    // blurred copy, hence their damage is not relevant
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (!surface || !surface->isMapped() || blurSurfaces.contains(surface))
+        return;
+
+    addDamage(region.translated(surface->globalPosition().toPoint()));
+}
+
+void BlurDamageTrackerPrivate::_q_surfaceGeometryChanged()
+{
+    Q_Q(BlurDamageTracker);
+
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (!surface || !surface->isMapped())
+        return;
+
+    QRect geometry = surface->globalGeometry().toAlignedRect();
+    QRect oldGeometry = geometries.value(surface);
+    geometries.insert(surface, geometry);
+
+    if (blurSurfaces.contains(surface))
+        addDamage(globalBlurRegion(surface));
+    else
+        addDamage(QRegion(oldGeometry) + geometry);
+}
+
+void BlurDamageTrackerPrivate::_q_surfaceMappedChanged()
+{
+    Q_Q(BlurDamageTracker);
+
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (!surface)
+        return;
+
+    // Appearing or disappearing windows change what's behind
+    QRect geometry = surface->globalGeometry().toAlignedRect();
+    if (surface->isMapped())
+        geometries.insert(surface, geometry);
+    else
+        geometries.remove(surface);
+    updateBlurSurface(surface);
+    if (!blurSurfaces.contains(surface))
+        addDamage(geometry);
+}
+
+void BlurDamageTrackerPrivate::_q_blurRegionChanged()
+{
+    Q_Q(BlurDamageTracker);
+
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (surface)
+        updateBlurSurface(surface);
+}
+
+void BlurDamageTrackerPrivate::_q_flush()
+{
+    for (Output *output: compositor->outputLayout()->outputs()) {
+        QRegion blurRegion;
+        for (QuickSurface *surface: blurSurfaces) {
+            if (surface->enteredOutputs().contains(output))
+                blurRegion += globalBlurRegion(surface);
+        }
+        blurRegion &= output->geometry();
+
+        output->setBlurBehindActive(!blurRegion.isEmpty());
+        if (blurRegion.intersects(damage))
+            Q_EMIT output->blurBehindDamaged();
+    }
+
+    damage = QRegion();
+}
+
+/*
+ * BlurDamageTracker
+ */
+
+BlurDamageTracker::BlurDamageTracker(Compositor *compositor)
+    : QObject(compositor)
+    , d_ptr(new BlurDamageTrackerPrivate(this))
+{
+    Q_D(BlurDamageTracker);
+    d->compositor = compositor;
+}
+
+BlurDamageTracker::~BlurDamageTracker()
+{
+    delete d_ptr;
+}
+
+void BlurDamageTracker::addSurface(QuickSurface *surface)
+{
+    connect(surface, SIGNAL(damaged(QRegion)),
+            this, SLOT(_q_surfaceDamaged(QRegion)));
+    connect(surface, SIGNAL(globalGeometryChanged()),
+            this, SLOT(_q_surfaceGeometryChanged()));
+    connect(surface, SIGNAL(mapped()),
+            this, SLOT(_q_surfaceMappedChanged()));
+    connect(surface, SIGNAL(unmapped()),
+            this, SLOT(_q_surfaceMappedChanged()));
+    connect(surface, SIGNAL(blurRegionChanged()),
+            this, SLOT(_q_blurRegionChanged()));
+    connect(surface, SIGNAL(contrastChanged()),
+            this, SLOT(_q_blurRegionChanged()));
+    connect(surface, &QObject::destroyed, this, [=]() {
+        Q_D(BlurDamageTracker);
+        QRect geometry = d->geometries.take(surface);
+        if (d->blurSurfaces.remove(surface))
+            d->flushTimer->start();
+        else
+            d->addDamage(geometry);
+    });
+}
+
+}
+
+#include "moc_blurdamagetracker.cpp"
@@ -0,0 +1,64 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef BLURDAMAGETRACKER_H
+#define BLURDAMAGETRACKER_H
+
+#include <QtCore/QObject>
+
+class QRegion;
+
+namespace GreenIsland {
+
+class BlurDamageTrackerPrivate;
+class Compositor;
+class QuickSurface;
+
+class BlurDamageTracker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BlurDamageTracker(Compositor *compositor);
+    ~BlurDamageTracker();
+
+    // Watch the surface for blur and contrast regions and
+    // for damage that changes what those regions are showing
+    void addSurface(QuickSurface *surface);
+
+private:
+    Q_DECLARE_PRIVATE(BlurDamageTracker)
+    BlurDamageTrackerPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_surfaceDamaged(const QRegion &region))
+    Q_PRIVATE_SLOT(d_func(), void _q_surfaceGeometryChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_surfaceMappedChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_blurRegionChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_flush())
+};
+
+}
+
+#endif // BLURDAMAGETRACKER_H
@@ -64,18 +64,31 @@ void ClientWindow::setSurface(QuickSurface *surface)
         if (!m_mapped)
             return;
 
-        switch (m_surface->visibility()) {
-        case QWindow::Minimized:
-            m_minimized = true;
-            break;
-        case QWindow::Maximized:
-            m_maximized = true;
-            break;
-        case QWindow::FullScreen:
-            m_fullScreen = true;
-            break;
-        default:
-            break;
+        // Hidden and automatic visibility follow whether the window
+        // is on screen (other workspace, overview, minimize animation)
+        // and say nothing about the window state, which is kept
+        QWindow::Visibility visibility = m_surface->visibility();
+        if (visibility == QWindow::Hidden || visibility == QWindow::AutomaticVisibility)
+            return;
+
+        // Minimizing keeps the state to restore, any other
+        // state replaces the previous one
+        bool minimized = visibility == QWindow::Minimized;
+        bool maximized = minimized ? m_maximized : visibility == QWindow::Maximized;
+        bool fullScreen = minimized ? m_fullScreen : visibility == QWindow::FullScreen;
+
+        // Notify only what actually changed
+        if (m_minimized != minimized) {
+            m_minimized = minimized;
+            Q_EMIT minimizedChanged();
+        }
+        if (m_maximized != maximized) {
+            m_maximized = maximized;
+            Q_EMIT maximizedChanged();
+        }
+        if (m_fullScreen != fullScreen) {
+            m_fullScreen = fullScreen;
+            Q_EMIT fullScreenChanged();
         }
     });
     QObject::connect(m_surface, &QWaylandSurface::mapped, [=]() {
@@ -89,7 +102,10 @@ void ClientWindow::setSurface(QuickSurface *surface)
 
         if (view) {
             QObject::connect(view, &QWaylandSurfaceItem::focusChanged, [=](bool focus) {
+                if (m_active == focus)
+                    return;
                 m_active = focus;
+                Q_EMIT activeChanged();
             });
         }
     });
@@ -125,8 +141,10 @@ void ClientWindow::activate()
         QWaylandSurfaceItem *view = compositor->firstViewOf(m_surface);
         if (view)
             view->takeFocus();
-        m_active = true;
-        Q_EMIT activeChanged();
+        if (m_active != true) {
+            m_active = true;
+            Q_EMIT activeChanged();
+        }
     }
 }
 
@@ -139,8 +157,10 @@ void ClientWindow::deactivate()
             view->setFocus(false);
             m_surface->compositor()->defaultInputDevice()->setKeyboardFocus(0);
         }
-        m_active = true;
-        Q_EMIT activeChanged();
+        if (m_active != false) {
+            m_active = false;
+            Q_EMIT activeChanged();
+        }
     }
 }
 
@@ -153,8 +173,12 @@ void ClientWindow::minimize()
 {
     if (m_surface && !m_minimized) {
         m_surface->setVisibility(QWindow::Minimized);
-        m_minimized = true;
-        Q_EMIT minimizedChanged();
+
+        // Visibility change handler might have already updated it
+        if (!m_minimized) {
+            m_minimized = true;
+            Q_EMIT minimizedChanged();
+        }
     }
 }
 
@@ -162,8 +186,12 @@ void ClientWindow::unminimize()
 {
     if (m_surface && m_minimized) {
         m_surface->setVisibility(QWindow::AutomaticVisibility);
-        m_minimized = false;
-        Q_EMIT minimizedChanged();
+
+        // Visibility change handler might have already updated it
+        if (m_minimized) {
+            m_minimized = false;
+            Q_EMIT minimizedChanged();
+        }
     }
 }
 
@@ -176,8 +204,12 @@ void ClientWindow::maximize()
 {
     if (m_surface && !m_maximized) {
         m_surface->setVisibility(QWindow::Maximized);
-        m_maximized = true;
-        Q_EMIT maximizedChanged();
+
+        // Visibility change handler might have already updated it
+        if (!m_maximized) {
+            m_maximized = true;
+            Q_EMIT maximizedChanged();
+        }
     }
 }
 
@@ -185,8 +217,12 @@ void ClientWindow::unmaximize()
 {
     if (m_surface && m_maximized) {
         m_surface->setVisibility(QWindow::Windowed);
-        m_maximized = false;
-        Q_EMIT maximizedChanged();
+
+        // Visibility change handler might have already updated it
+        if (m_maximized) {
+            m_maximized = false;
+            Q_EMIT maximizedChanged();
+        }
     }
 }
 
@@ -199,8 +235,12 @@ void ClientWindow::setFullScreen(bool fs)
 {
     if (m_surface && m_fullScreen != fs) {
         m_surface->setVisibility(fs ? QWindow::FullScreen : QWindow::AutomaticVisibility);
-        m_fullScreen = fs;
-        Q_EMIT fullScreenChanged();
+
+        // Visibility change handler might have already updated it
+        if (m_fullScreen != fs) {
+            m_fullScreen = fs;
+            Q_EMIT fullScreenChanged();
+        }
     }
 }
 
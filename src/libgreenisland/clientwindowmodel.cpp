@@ -0,0 +1,247 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "clientwindow.h"
+#include "clientwindowmodel.h"
+
+namespace GreenIsland {
+
+/*
+ * ClientWindowModelPrivate
+ */
+
+class ClientWindowModelPrivate
+{
+public:
+    ClientWindowModelPrivate(ClientWindowModel *self);
+
+    void scheduleChange(ClientWindow *window, int role);
+
+    void _q_flushChanges();
+
+    QList<ClientWindow *> windows;
+    QHash<ClientWindow *, int> rows;
+
+    // Role changes are collected and notified once per event loop
+    // iteration, so that several changes to a window within a frame
+    // result in only one update for the views
+    QHash<ClientWindow *, QVector<int> > pendingChanges;
+    QTimer *flushTimer;
+
+private:
+    Q_DECLARE_PUBLIC(ClientWindowModel)
+    ClientWindowModel *const q_ptr;
+};
+
+ClientWindowModelPrivate::ClientWindowModelPrivate(ClientWindowModel *self)
+    : q_ptr(self)
+{
+    flushTimer = new QTimer(self);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(0);
+    self->connect(flushTimer, SIGNAL(timeout()),
+                  self, SLOT(_q_flushChanges()));
+}
+
+void ClientWindowModelPrivate::scheduleChange(ClientWindow *window, int role)
+{
+    QVector<int> &roles = pendingChanges[window];
+    if (!roles.contains(role))
+        roles.append(role);
+
+    if (!flushTimer->isActive())
+        flushTimer->start();
+}
+
+void ClientWindowModelPrivate::_q_flushChanges()
+{
+    Q_Q(ClientWindowModel);
+
+    QHash<ClientWindow *, QVector<int> > changes = pendingChanges;
+    pendingChanges.clear();
+
+    QHash<ClientWindow *, QVector<int> >::const_iterator it;
+    for (it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        int row = rows.value(it.key(), -1);
+        if (row < 0)
+            continue;
+
+        QModelIndex index = q->index(row);
+        Q_EMIT q->dataChanged(index, index, it.value());
+    }
+}
+
+/*
+ * ClientWindowModel
+ */
+
+ClientWindowModel::ClientWindowModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , d_ptr(new ClientWindowModelPrivate(this))
+{
+}
+
+ClientWindowModel::~ClientWindowModel()
+{
+    delete d_ptr;
+}
+
+QHash<int, QByteArray> ClientWindowModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[WindowRole] = "window";
+    roles[TitleRole] = "title";
+    roles[AppIdRole] = "appId";
+    roles[ActiveRole] = "active";
+    roles[MinimizedRole] = "minimized";
+    roles[MaximizedRole] = "maximized";
+    roles[FullScreenRole] = "fullScreen";
+    return roles;
+}
+
+int ClientWindowModel::rowCount(const QModelIndex &parent) const
+{
+    Q_D(const ClientWindowModel);
+
+    if (parent.isValid())
+        return 0;
+    return d->windows.size();
+}
+
+QVariant ClientWindowModel::data(const QModelIndex &index, int role) const
+{
+    Q_D(const ClientWindowModel);
+
+    if (!index.isValid() || index.row() >= d->windows.size())
+        return QVariant();
+
+    ClientWindow *window = d->windows.at(index.row());
+
+    switch (role) {
+    case WindowRole:
+        return QVariant::fromValue(window);
+    case Qt::DisplayRole:
+    case TitleRole:
+        return window->title();
+    case AppIdRole:
+        return window->appId();
+    case ActiveRole:
+        return window->isActive();
+    case MinimizedRole:
+        return window->isMinimized();
+    case MaximizedRole:
+        return window->isMaximized();
+    case FullScreenRole:
+        return window->isFullScreen();
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+ClientWindow *ClientWindowModel::get(int row) const
+{
+    Q_D(const ClientWindowModel);
+    return d->windows.value(row, Q_NULLPTR);
+}
+
+int ClientWindowModel::indexOf(ClientWindow *window) const
+{
+    Q_D(const ClientWindowModel);
+    return d->rows.value(window, -1);
+}
+
+QList<ClientWindow *> ClientWindowModel::windows() const
+{
+    Q_D(const ClientWindowModel);
+    return d->windows;
+}
+
+void ClientWindowModel::addWindow(ClientWindow *window)
+{
+    Q_D(ClientWindowModel);
+
+    if (!window || d->rows.contains(window))
+        return;
+
+    int row = d->windows.size();
+    beginInsertRows(QModelIndex(), row, row);
+    d->windows.append(window);
+    d->rows.insert(window, row);
+    endInsertRows();
+
+    // Update roles when the window changes
+    connect(window, &ClientWindow::titleChanged, this, [=]() {
+        d->scheduleChange(window, TitleRole);
+    });
+    connect(window, &ClientWindow::appIdChanged, this, [=]() {
+        d->scheduleChange(window, AppIdRole);
+    });
+    connect(window, &ClientWindow::activeChanged, this, [=]() {
+        d->scheduleChange(window, ActiveRole);
+    });
+    connect(window, &ClientWindow::minimizedChanged, this, [=]() {
+        d->scheduleChange(window, MinimizedRole);
+    });
+    connect(window, &ClientWindow::maximizedChanged, this, [=]() {
+        d->scheduleChange(window, MaximizedRole);
+    });
+    connect(window, &ClientWindow::fullScreenChanged, this, [=]() {
+        d->scheduleChange(window, FullScreenRole);
+    });
+
+    Q_EMIT countChanged();
+}
+
+void ClientWindowModel::removeWindow(ClientWindow *window)
+{
+    Q_D(ClientWindowModel);
+
+    int row = d->rows.value(window, -1);
+    if (row < 0)
+        return;
+
+    window->disconnect(this);
+    d->pendingChanges.remove(window);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    d->windows.removeAt(row);
+    d->rows.remove(window);
+    for (int i = row; i < d->windows.size(); i++)
+        d->rows[d->windows.at(i)] = i;
+    endRemoveRows();
+
+    Q_EMIT countChanged();
+}
+
+}
+
+#include "moc_clientwindowmodel.cpp"
@@ -0,0 +1,82 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef CLIENTWINDOWMODEL_H
+#define CLIENTWINDOWMODEL_H
+
+#include <QtCore/QAbstractListModel>
+
+#include <greenisland/greenisland_export.h>
+
+namespace GreenIsland {
+
+class ClientWindow;
+class ClientWindowModelPrivate;
+
+class GREENISLAND_EXPORT ClientWindowModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+public:
+    enum Roles {
+        WindowRole = Qt::UserRole + 1,
+        TitleRole,
+        AppIdRole,
+        ActiveRole,
+        MinimizedRole,
+        MaximizedRole,
+        FullScreenRole
+    };
+
+    ClientWindowModel(QObject *parent = 0);
+    ~ClientWindowModel();
+
+    QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+
+    Q_INVOKABLE ClientWindow *get(int row) const;
+    Q_INVOKABLE int indexOf(ClientWindow *window) const;
+
+    QList<ClientWindow *> windows() const;
+
+    void addWindow(ClientWindow *window);
+    void removeWindow(ClientWindow *window);
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    Q_DECLARE_PRIVATE(ClientWindowModel)
+    ClientWindowModelPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_flushChanges())
+};
+
+}
+
+#endif // CLIENTWINDOWMODEL_H
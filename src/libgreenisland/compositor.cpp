@@ -25,10 +25,16 @@
  ***************************************************************************/
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QProcess>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QScreen>
 #include <QtCore/QVariantMap>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickWindow>
 #include <QtCompositor/QWaylandSurface>
@@ -42,14 +48,24 @@
 #ifdef QT_COMPOSITOR_WAYLAND_GL
 #  include "bufferattacher.h"
 #endif
+#include "blurdamagetracker.h"
 #include "cmakedirs.h"
 #include "clientwindow.h"
+#include "clientwindowmodel.h"
 #include "compositor.h"
 #include "config.h"
+#include "output.h"
+#include "outputlayout.h"
+#include "outputwindow.h"
 #include "quicksurface.h"
+#include "windowplacement.h"
 #include "windowview.h"
 #include "screenmanager.h"
 #include "shellwindowview.h"
+#include "startupmonitor.h"
+#include "surfacemodel.h"
+#include "texturebudget.h"
+#include "workspacemanager.h"
 
 #include "protocols/plasma/plasmaeffects.h"
 #include "protocols/plasma/plasmashell.h"
@@ -64,6 +80,11 @@ namespace GreenIsland {
 
 QString Compositor::s_fixedPlugin;
 
+// Surfaces that are not visible on any output still get frame
+// callbacks at this rate, so that clients waiting for them don't
+// stall forever but don't render at full speed either
+static const int s_keepAliveInterval = 1000;
+
 /*
  * CompositorPrivate
  */
@@ -73,9 +94,19 @@ class CompositorPrivate
 public:
     CompositorPrivate(Compositor *self);
 
-    void dpms(bool on);
+    void setRenderingEnabled(bool enabled);
+
+    QUrl shellUrl() const;
+    void loadShell();
 
     void _q_updateCursor(bool hasBuffer);
+    void _q_sendKeepAliveCallbacks();
+    void _q_checkIdle();
+    void _q_layoutChanged();
+    void _q_workspaceSelected();
+
+    // Minimized windows and windows on other workspaces are not drawn
+    bool isSurfaceHidden(QWaylandSurface *surface) const;
 
     bool running;
 
@@ -83,12 +114,38 @@ public:
     int idleInterval;
     int idleInhibit;
 
+    // Idle detection
+    QElapsedTimer lastActivity;
+    QTimer *idleTimer;
+
     // Cursor
     QWaylandSurface *cursorSurface;
     int cursorHotspotX;
     int cursorHotspotY;
 
     ScreenManager *screenManager;
+    OutputLayout *outputLayout;
+    WindowPlacement *windowPlacement;
+    BlurDamageTracker *blurDamageTracker;
+
+    // Window representations of all surfaces
+    SurfaceModel *surfaceModel;
+
+    // Workspace of each application window
+    WorkspaceManager *workspaceManager;
+
+    // Textures of surfaces hidden for a while
+    TextureBudget *textureBudget;
+
+    // Application windows
+    ClientWindowModel *windowModel;
+
+    // QML engine and shell component shared by all outputs
+    QQmlEngine *engine;
+    QQmlComponent *shellComponent;
+
+    // Frame callbacks for hidden surfaces
+    QTimer *keepAliveTimer;
 
 protected:
     Q_DECLARE_PUBLIC(Compositor)
@@ -103,15 +160,96 @@ CompositorPrivate::CompositorPrivate(Compositor *self)
     , cursorSurface(Q_NULLPTR)
     , cursorHotspotX(0)
     , cursorHotspotY(0)
+    , screenManager(Q_NULLPTR)
+    , outputLayout(new OutputLayout(self))
+    , windowPlacement(Q_NULLPTR)
+    , blurDamageTracker(Q_NULLPTR)
+    , surfaceModel(new SurfaceModel(self))
+    , workspaceManager(Q_NULLPTR)
+    , textureBudget(Q_NULLPTR)
+    , windowModel(new ClientWindowModel(self))
+    , engine(new QQmlEngine())
+    , shellComponent(Q_NULLPTR)
     , q_ptr(self)
 {
-    screenManager = new ScreenManager(self);
+    // Make compositor instance available to QML
+    engine->rootContext()->setContextProperty("compositor", self);
+
+    idleTimer = new QTimer(self);
+    idleTimer->setSingleShot(true);
+    self->connect(idleTimer, SIGNAL(timeout()),
+                  self, SLOT(_q_checkIdle()));
+
+    keepAliveTimer = new QTimer(self);
+    keepAliveTimer->setInterval(s_keepAliveInterval);
+    self->connect(keepAliveTimer, SIGNAL(timeout()),
+                  self, SLOT(_q_sendKeepAliveCallbacks()));
+}
+
+void CompositorPrivate::setRenderingEnabled(bool enabled)
+{
+    Q_Q(Compositor);
+
+    // Output windows are blanked rather than hidden, hidden windows
+    // don't get input events and those wake the compositor up; the
+    // scene graph is preserved so that rendering resumes quickly
+    for (QWaylandOutput *output: q->outputs()) {
+        OutputWindow *window = static_cast<OutputWindow *>(output->window());
+        if (window)
+            window->setRenderingEnabled(enabled);
+    }
+
+    if (enabled && running)
+        keepAliveTimer->start();
+    else
+        keepAliveTimer->stop();
+}
+
+QUrl CompositorPrivate::shellUrl() const
+{
+    // Without a plugin we load the shell built into the executable,
+    // which might have been compiled ahead of time
+    if (Compositor::s_fixedPlugin.isEmpty())
+        return QUrl(QStringLiteral("qrc:/qml/Compositor.qml"));
+
+    QString path = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
+                                          QString("greenisland/%1/Compositor.qml").arg(Compositor::s_fixedPlugin));
+    if (path.isEmpty())
+        qFatal("Plugin \"%s\" is not valid, cannot continue!",
+               qPrintable(Compositor::s_fixedPlugin));
+
+    return QUrl::fromLocalFile(path);
 }
 
-void CompositorPrivate::dpms(bool on)
+void CompositorPrivate::loadShell()
 {
-    // TODO
-    Q_UNUSED(on);
+    if (Compositor::s_fixedPlugin.isEmpty())
+        qDebug() << "Loading built-in shell";
+    else
+        qDebug() << "Loading" << Compositor::s_fixedPlugin << "plugin";
+
+    // Compile the shell in the background, output windows will
+    // instantiate it as soon as they are created
+    shellComponent = new QQmlComponent(engine, engine);
+    QObject::connect(shellComponent, &QQmlComponent::statusChanged,
+                     [=](QQmlComponent::Status status) {
+        if (status == QQmlComponent::Ready) {
+            StartupMonitor::instance()->mark(QStringLiteral("shell-loaded"));
+        } else if (status == QQmlComponent::Error) {
+            for (const QQmlError &error: shellComponent->errors())
+                qWarning() << error;
+
+            // The built-in shell is missing when the executable was
+            // linked without resources, while ahead of time compiled
+            // code is refused when it doesn't match the Qt libraries
+            if (Compositor::s_fixedPlugin.isEmpty())
+                qFatal("Built-in shell is missing or was compiled for another Qt version, "
+                       "please pass a plugin or rebuild Green Island!");
+            qFatal("Plugin \"%s\" has errors, cannot continue!",
+                   qPrintable(Compositor::s_fixedPlugin));
+        }
+    });
+    shellComponent->loadUrl(shellUrl(), QQmlComponent::Asynchronous);
 }
 
 void CompositorPrivate::_q_updateCursor(bool hasBuffer)
@@ -133,6 +271,66 @@ void CompositorPrivate::_q_updateCursor(bool hasBuffer)
 #endif
 }
 
+void CompositorPrivate::_q_sendKeepAliveCallbacks()
+{
+    Q_Q(Compositor);
+
+    QList<QWaylandSurface *> hiddenSurfaces;
+    for (QWaylandSurface *surface: q->surfaces()) {
+        if (isSurfaceHidden(surface))
+            hiddenSurfaces.append(surface);
+    }
+
+    if (!hiddenSurfaces.isEmpty())
+        q->sendFrameCallbacks(hiddenSurfaces);
+}
+
+void CompositorPrivate::_q_checkIdle()
+{
+    Q_Q(Compositor);
+
+    // Inhibitors will restart the timer when they go away
+    if (state != Compositor::Active || idleInhibit > 0)
+        return;
+
+    // Input only updates the timestamp, here we find out whether
+    // there was activity since the timer was started and sleep
+    // again for the remaining time
+    qint64 elapsed = lastActivity.elapsed();
+    if (elapsed >= idleInterval)
+        q->setState(Compositor::Idle);
+    else
+        idleTimer->start(idleInterval - elapsed);
+}
+
+void CompositorPrivate::_q_layoutChanged()
+{
+    Q_Q(Compositor);
+
+    for (QWaylandSurface *surface: q->surfaces()) {
+        QuickSurface *quickSurface = qobject_cast<QuickSurface *>(surface);
+        if (quickSurface)
+            quickSurface->updateOutputs();
+    }
+}
+
+void CompositorPrivate::_q_workspaceSelected()
+{
+    Q_Q(Compositor);
+
+    // Windows of the new workspace were only served by the keep
+    // alive timer, let them draw again right away
+    q->sendFrameCallbacks(q->visibleSurfaces());
+}
+
+bool CompositorPrivate::isSurfaceHidden(QWaylandSurface *surface) const
+{
+    if (surface->visibility() == QWindow::Hidden ||
+            surface->visibility() == QWindow::Minimized)
+        return true;
+    return !workspaceManager->isOnCurrentWorkspace(surface);
+}
+
 /*
  * Compositor
  */
@@ -145,12 +343,30 @@ Compositor::Compositor(const QString &socket)
     qRegisterMetaType<Output *>("Output*");
     qRegisterMetaType<WindowView *>("WindowView*");
     qRegisterMetaType<ShellWindowView *>("ShellWindowView*");
+
+    Q_D(Compositor);
+
+    // Compile QML while the screen configuration is being fetched,
+    // the Wayland socket is already open at this point
+    d->loadShell();
+    d->screenManager = new ScreenManager(this);
+    d->windowPlacement = new WindowPlacement(this);
+    d->blurDamageTracker = new BlurDamageTracker(this);
+    d->workspaceManager = new WorkspaceManager(this);
+    connect(d->workspaceManager, SIGNAL(workspaceSelected(int)),
+            this, SLOT(_q_workspaceSelected()));
+    d->textureBudget = new TextureBudget(this);
+
+    // Surfaces may enter or leave outputs when the layout changes
+    connect(d->outputLayout, SIGNAL(layoutChanged()),
+            this, SLOT(_q_layoutChanged()));
 }
 
 Compositor::~Compositor()
 {
     // Cleanup
-    qDeleteAll(m_clientWindows);
+    QQmlEngine *engine = d_ptr->engine;
+    qDeleteAll(m_clientWindowForSurface);
     delete d_ptr->screenManager;
     delete d_ptr;
 
@@ -161,6 +377,9 @@ Compositor::~Compositor()
             output->window()->deleteLater();
         output->deleteLater();
     }
+
+    // Output windows use the engine, delete it after them
+    engine->deleteLater();
 }
 
 Compositor::State Compositor::state() const
@@ -173,46 +392,41 @@ void Compositor::setState(Compositor::State state)
 {
     Q_D(Compositor);
 
-    if (state == Compositor::Active && d->state == state) {
-        Q_EMIT idleInhibitResetRequested();
-        Q_EMIT idleTimerStartRequested();
+    if (d->state == state)
         return;
-    }
-
-    if (d->state != state) {
-        switch (state) {
-        case Compositor::Active:
-            switch (d->state) {
-            case Compositor::Sleeping:
-                d->dpms(true);
-            default:
-                Q_EMIT wake();
-                Q_EMIT idleInhibitResetRequested();
-                Q_EMIT idleTimerStartRequested();
-            }
-        case Compositor::Idle:
-            Q_EMIT idle();
-            Q_EMIT idleInhibitResetRequested();
-            Q_EMIT idleTimerStopRequested();
-            break;
-        case Compositor::Offscreen:
-            switch (d->state) {
-            case Compositor::Sleeping:
-                d->dpms(true);
-            default:
-                Q_EMIT idleInhibitResetRequested();
-                Q_EMIT idleTimerStopRequested();
-            }
-        case Compositor::Sleeping:
-            Q_EMIT idleInhibitResetRequested();
-            Q_EMIT idleTimerStopRequested();
-            d->dpms(false);
-            break;
-        }
 
-        d->state = state;
-        Q_EMIT stateChanged();
+    Compositor::State oldState = d->state;
+    d->state = state;
+
+    // Stop or resume rendering when we go to or come from
+    // either Offscreen or Sleeping
+    bool wasRendering = oldState == Compositor::Active || oldState == Compositor::Idle;
+    bool rendering = state == Compositor::Active || state == Compositor::Idle;
+    if (wasRendering != rendering)
+        d->setRenderingEnabled(rendering);
+
+    switch (state) {
+    case Compositor::Active:
+        d->lastActivity.restart();
+        d->_q_checkIdle();
+        Q_EMIT wake();
+        break;
+    case Compositor::Idle:
+        d->idleTimer->stop();
+        Q_EMIT idle();
+        break;
+    case Compositor::Offscreen:
+        d->idleTimer->stop();
+        break;
+    case Compositor::Sleeping:
+        // Neither KScreen nor Qt do power management and output
+        // windows are already blank, so this is the same as
+        // Offscreen for now
+        d->idleTimer->stop();
+        break;
     }
+
+    Q_EMIT stateChanged();
 }
 
 int Compositor::idleInterval() const
@@ -228,6 +442,10 @@ void Compositor::setIdleInterval(int value)
     if (d->idleInterval != value) {
         d->idleInterval = value;
         Q_EMIT idleIntervalChanged();
+
+        // Reschedule the check according to the new interval
+        if (d->running)
+            d->_q_checkIdle();
     }
 }
 
@@ -241,18 +459,104 @@ void Compositor::setIdleInhibit(int value)
 {
     Q_D(Compositor);
 
+    if (value < 0) {
+        qWarning() << "Idle inhibit count cannot be negative!";
+        value = 0;
+    }
+
     if (d->idleInhibit != value) {
+        bool wasInhibited = d->idleInhibit > 0;
         d->idleInhibit = value;
         Q_EMIT idleInhibitChanged();
+
+        // Nothing can happen while inhibited, when the last inhibitor
+        // goes away we start counting from now
+        if (value > 0) {
+            d->idleTimer->stop();
+        } else if (wasInhibited && d->running) {
+            d->lastActivity.restart();
+            d->_q_checkIdle();
+        }
     }
 }
 
+void Compositor::incrementIdleInhibit()
+{
+    Q_D(Compositor);
+    setIdleInhibit(d->idleInhibit + 1);
+}
+
+void Compositor::decrementIdleInhibit()
+{
+    Q_D(Compositor);
+    setIdleInhibit(d->idleInhibit - 1);
+}
+
+int Compositor::textureBudget() const
+{
+    Q_D(const Compositor);
+    return d->textureBudget->budget() / (1024 * 1024);
+}
+
+void Compositor::setTextureBudget(int mib)
+{
+    Q_D(Compositor);
+
+    if (textureBudget() == mib)
+        return;
+
+    d->textureBudget->setBudget(qint64(mib) * 1024 * 1024);
+    Q_EMIT textureBudgetChanged();
+}
+
+void Compositor::reportActivity()
+{
+    Q_D(Compositor);
+
+    // This is called for every input event, just take note of
+    // the time and let the idle timer do the rest
+    d->lastActivity.restart();
+
+    if (d->state != Compositor::Active)
+        setState(Compositor::Active);
+}
+
 ScreenManager *Compositor::screenManager() const
 {
     Q_D(const Compositor);
     return d->screenManager;
 }
 
+SurfaceModel *Compositor::surfaceModel() const
+{
+    Q_D(const Compositor);
+    return d->surfaceModel;
+}
+
+WorkspaceManager *Compositor::workspaceManager() const
+{
+    Q_D(const Compositor);
+    return d->workspaceManager;
+}
+
+OutputLayout *Compositor::outputLayout() const
+{
+    Q_D(const Compositor);
+    return d->outputLayout;
+}
+
+QQmlEngine *Compositor::engine() const
+{
+    Q_D(const Compositor);
+    return d->engine;
+}
+
+QQmlComponent *Compositor::shellComponent() const
+{
+    Q_D(const Compositor);
+    return d->shellComponent;
+}
+
 void Compositor::run()
 {
     Q_D(Compositor);
@@ -268,10 +572,19 @@ void Compositor::run()
 
     d->running = true;
 
+    // Start sending frame callbacks to hidden surfaces
+    if (d->state == Compositor::Active || d->state == Compositor::Idle)
+        d->keepAliveTimer->start();
+
+    // Start idle detection
+    d->lastActivity.start();
+    d->_q_checkIdle();
+
 #if HAVE_SYSTEMD
     qDebug() << "Compositor ready, notify systemd on" << qgetenv("NOTIFY_SOCKET");
     sd_notify(0, "READY=1");
 #endif
+    StartupMonitor::instance()->mark(QStringLiteral("compositor-ready"));
 }
 
 QWaylandSurface *Compositor::createSurface(QWaylandClient *client, quint32 id, int version)
@@ -284,17 +597,19 @@ QWaylandSurfaceView *Compositor::pickView(const QPointF &globalPosition) const
     // TODO: Views should probably ordered by z-index in order to really
     // pick the first view with that global coordinates
 
-    for (QWaylandOutput *output: m_compositor->outputs()) {
-        if (output->geometry().contains(globalPosition.toPoint())) {
-            for (QWaylandSurface *surface: output->surfaces()) {
-                QuickSurface *quickSurface = qobject_cast<QuickSurface *>(surface);
-                if (!quickSurface)
-                    continue;
+    Q_D(const Compositor);
 
-                if (quickSurface->globalGeometry().contains(globalPosition))
-                    return quickSurface->views().at(0);
-            }
-        }
+    Output *output = d->outputLayout->outputAt(globalPosition);
+    if (!output)
+        return Q_NULLPTR;
+
+    for (QWaylandSurface *surface: output->surfaces()) {
+        QuickSurface *quickSurface = qobject_cast<QuickSurface *>(surface);
+        if (!quickSurface)
+            continue;
+
+        if (quickSurface->globalGeometry().contains(globalPosition))
+            return quickSurface->views().at(0);
     }
 
     return Q_NULLPTR;
@@ -338,13 +653,26 @@ QWaylandSurfaceItem *Compositor::viewForOutput(QuickSurface *surface, Output *ou
 
 void Compositor::surfaceCreated(QWaylandSurface *surface)
 {
+    Q_D(Compositor);
+
     if (!surface)
         return;
 
     // Create application window instance
     ClientWindow *appWindow = new ClientWindow(this);
     appWindow->setSurface(qobject_cast<QuickSurface *>(surface));
-    m_clientWindows.append(appWindow);
+    m_clientWindowForSurface.insert(surface, appWindow);
+    d->windowModel->addWindow(appWindow);
+
+    // Keep track of free space, of what blur regions show,
+    // of the workspace of each window and of its texture
+    QuickSurface *quickSurface = qobject_cast<QuickSurface *>(surface);
+    if (quickSurface) {
+        d->windowPlacement->addSurface(quickSurface);
+        d->blurDamageTracker->addSurface(quickSurface);
+        d->workspaceManager->addSurface(quickSurface);
+        d->textureBudget->addSurface(quickSurface);
+    }
 
     // Connect surface signals
     connect(surface, &QWaylandSurface::mapped, [=]() {
@@ -353,16 +681,24 @@ void Compositor::surfaceCreated(QWaylandSurface *surface)
     connect(surface, &QWaylandSurface::unmapped, [=]() {
         Q_EMIT surfaceUnmapped(QVariant::fromValue(surface));
     });
+    connect(surface, &QWaylandSurface::visibilityChanged, [=]() {
+        // Frame callbacks are not sent while the surface is hidden,
+        // now that it's back on screen let the client draw again
+        if (!d->isSurfaceHidden(surface))
+            sendFrameCallbacks(QList<QWaylandSurface *>() << surface);
+    });
     connect(surface, &QWaylandSurface::surfaceDestroyed, [=]() {
         Q_EMIT surfaceDestroyed(QVariant::fromValue(surface));
 
+        // Window representations were destroyed by the shell by now
+        d->surfaceModel->removeSurface(qobject_cast<QuickSurface *>(surface));
+        d->workspaceManager->removeSurface(qobject_cast<QuickSurface *>(surface));
+
         // Delete application window on surface destruction
-        for (ClientWindow *appWindow: m_clientWindows) {
-            if (appWindow->surface() == surface) {
-                if (m_clientWindows.removeOne(appWindow))
-                    appWindow->deleteLater();
-                break;
-            }
+        ClientWindow *appWindow = m_clientWindowForSurface.take(surface);
+        if (appWindow) {
+            d->windowModel->removeWindow(appWindow);
+            appWindow->deleteLater();
         }
     });
 }
@@ -375,40 +711,26 @@ QPointF Compositor::calculateInitialPosition(QWaylandSurface *surface)
     QPointF pos = defaultInputDevice()->handle()->pointerDevice()->currentPosition();
 
     // Find the target screen (the one where the coordinates are in)
-    QRect geometry;
-    bool targetScreenFound = false;
-    for (int i = 0; i < outputs().size(); i++) {
-        geometry = outputs().at(i)->availableGeometry();
-        if (geometry.contains(pos.toPoint())) {
-            targetScreenFound = true;
-            break;
-        }
-    }
+    Q_D(Compositor);
+    Output *output = d->outputLayout->outputAt(pos);
 
     // Just move the surface to a random position if we can't find a target output
-    if (!targetScreenFound) {
+    if (!output) {
         pos.setX(10 + qrand() % 400);
         pos.setY(10 + qrand() % 400);
         return pos;
     }
 
-    // Valid range within output where the surface will still be onscreen.
-    // If this is negative it means that the surface is bigger than
-    // output in this case we fallback to 0,0 in available geometry space.
-    int rangeX = geometry.size().width() - surface->size().width();
-    int rangeY = geometry.size().height() - surface->size().height();
-
-    int dx = 0, dy = 0;
-    if (rangeX > 0)
-        dx = qrand() % rangeX;
-    if (rangeY > 0)
-        dy = qrand() % rangeY;
-
-    // Set surface position
-    pos.setX(geometry.x() + dx);
-    pos.setY(geometry.y() + dy);
+    // Place the window where there's free space
+    QuickSurface *quickSurface = qobject_cast<QuickSurface *>(surface);
+    if (quickSurface)
+        return d->windowPlacement->place(quickSurface, output);
+    return d->outputLayout->availableGeometry(output).topLeft();
+}
 
-    return pos;
+QVariantList Compositor::startupPhases() const
+{
+    return StartupMonitor::instance()->phases();
 }
 
 void Compositor::abortSession()
@@ -416,19 +738,40 @@ void Compositor::abortSession()
     QGuiApplication::quit();
 }
 
-QQmlListProperty<ClientWindow> Compositor::windows()
+ClientWindowModel *Compositor::windows() const
 {
-    return QQmlListProperty<ClientWindow>(this, m_clientWindows);
+    Q_D(const Compositor);
+    return d->windowModel;
 }
 
 int Compositor::windowCount() const
 {
-    return m_clientWindows.count();
+    Q_D(const Compositor);
+    return d->windowModel->rowCount();
 }
 
 ClientWindow *Compositor::window(int index) const
 {
-    return m_clientWindows.at(index);
+    Q_D(const Compositor);
+    return d->windowModel->get(index);
+}
+
+QList<ClientWindow *> Compositor::windowsList() const
+{
+    Q_D(const Compositor);
+    return d->windowModel->windows();
+}
+
+QList<QWaylandSurface *> Compositor::visibleSurfaces() const
+{
+    Q_D(const Compositor);
+
+    QList<QWaylandSurface *> list;
+    for (QWaylandSurface *surface: surfaces()) {
+        if (!d->isSurfaceHidden(surface))
+            list.append(surface);
+    }
+    return list;
 }
 
 void Compositor::setCursorSurface(QWaylandSurface *surface, int hotspotX, int hotspotY)
@@ -32,13 +32,20 @@
 
 #include <greenisland/greenisland_export.h>
 
+class QQmlComponent;
+class QQmlEngine;
+
 namespace GreenIsland {
 
 class ClientWindow;
+class ClientWindowModel;
 class CompositorPrivate;
 class Output;
+class OutputLayout;
 class QuickSurface;
 class ScreenManager;
+class SurfaceModel;
+class WorkspaceManager;
 
 class GREENISLAND_EXPORT Compositor : public QObject, public QWaylandQuickCompositor
 {
@@ -46,7 +53,10 @@ class GREENISLAND_EXPORT Compositor : public QObject, public QWaylandQuickCompos
     Q_PROPERTY(State state READ state WRITE setState NOTIFY stateChanged)
     Q_PROPERTY(int idleInterval READ idleInterval WRITE setIdleInterval NOTIFY idleIntervalChanged)
     Q_PROPERTY(int idleInhibit READ idleInhibit WRITE setIdleInhibit NOTIFY idleInhibitChanged)
-    Q_PROPERTY(QQmlListProperty<ClientWindow> windows READ windows)
+    Q_PROPERTY(ClientWindowModel *windows READ windows CONSTANT)
+    Q_PROPERTY(SurfaceModel *surfaceModel READ surfaceModel CONSTANT)
+    Q_PROPERTY(WorkspaceManager *workspaceManager READ workspaceManager CONSTANT)
+    Q_PROPERTY(int textureBudget READ textureBudget WRITE setTextureBudget NOTIFY textureBudgetChanged)
     Q_ENUMS(State)
 public:
     enum State {
@@ -72,7 +82,24 @@ public:
     int idleInhibit() const;
     void setIdleInhibit(int value);
 
+    Q_INVOKABLE void incrementIdleInhibit();
+    Q_INVOKABLE void decrementIdleInhibit();
+
+    // Texture memory in MiB surfaces hidden for a while
+    // may take before being evicted, 0 means no limit
+    int textureBudget() const;
+    void setTextureBudget(int mib);
+
+    void reportActivity();
+
     ScreenManager *screenManager() const;
+    OutputLayout *outputLayout() const;
+
+    SurfaceModel *surfaceModel() const;
+    WorkspaceManager *workspaceManager() const;
+
+    QQmlEngine *engine() const;
+    QQmlComponent *shellComponent() const;
 
     void run();
 
@@ -87,14 +114,18 @@ public:
 
     Q_INVOKABLE QPointF calculateInitialPosition(QWaylandSurface *surface);
 
+    Q_INVOKABLE QVariantList startupPhases() const;
+
     Q_INVOKABLE void abortSession();
 
-    QQmlListProperty<ClientWindow> windows();
+    ClientWindowModel *windows() const;
     int windowCount() const;
     ClientWindow *window(int) const;
 
     QList<ClientWindow *> windowsList() const;
 
+    QList<QWaylandSurface *> visibleSurfaces() const;
+
     static QString s_fixedPlugin;
 
 Q_SIGNALS:
@@ -105,10 +136,7 @@ Q_SIGNALS:
     void stateChanged();
     void idleIntervalChanged();
     void idleInhibitChanged();
-
-    void idleInhibitResetRequested();
-    void idleTimerStartRequested();
-    void idleTimerStopRequested();
+    void textureBudgetChanged();
 
     void idle();
     void wake();
@@ -126,9 +154,13 @@ private:
     CompositorPrivate *const d_ptr;
 
 private:
-    QList<ClientWindow *> m_clientWindows;
+    QHash<QWaylandSurface *, ClientWindow *> m_clientWindowForSurface;
 
     Q_PRIVATE_SLOT(d_func(), void _q_updateCursor(bool hasBuffer))
+    Q_PRIVATE_SLOT(d_func(), void _q_sendKeepAliveCallbacks())
+    Q_PRIVATE_SLOT(d_func(), void _q_checkIdle())
+    Q_PRIVATE_SLOT(d_func(), void _q_layoutChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_workspaceSelected())
 };
 
 }
@@ -156,6 +156,7 @@ bool HomeApplication::run(const QString &plugin)
 
     // Create the compositor
     m_compositor = new GreenIsland::Compositor(m_socket);
+    m_compositor->setIdleInterval(m_idleTime);
     m_compositor->run();
 
     return true;
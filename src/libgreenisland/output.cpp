@@ -30,6 +30,7 @@
 
 #include "compositor.h"
 #include "output.h"
+#include "outputlayout.h"
 #include "outputwindow.h"
 
 namespace GreenIsland {
@@ -49,6 +50,7 @@ public:
     Compositor *compositor;
     KScreen::OutputPtr output;
     bool primary;
+    bool blurBehindActive;
 
 private:
     Q_DECLARE_PUBLIC(Output)
@@ -59,6 +61,7 @@ OutputPrivate::OutputPrivate(Output *parent)
     : compositor(Q_NULLPTR)
     , output(Q_NULLPTR)
     , primary(false)
+    , blurBehindActive(false)
     , q_ptr(parent)
 {
 }
@@ -131,6 +134,12 @@ Output::Output(Compositor *compositor, const KScreen::OutputPtr &output)
     connect(output.data(), SIGNAL(posChanged()),
             this, SLOT(_q_posChanged()),
             Qt::UniqueConnection);
+    connect(output.data(), SIGNAL(rotationChanged()),
+            this, SLOT(_q_currentModeIdChanged()),
+            Qt::UniqueConnection);
+
+    // Add to the layout
+    compositor->outputLayout()->addOutput(this);
 
     // Show window
     OutputWindow *outputWindow = qobject_cast<OutputWindow *>(quickWindow());
@@ -179,6 +188,23 @@ void Output::setPrimary(bool value)
     Q_EMIT primaryChanged();
 }
 
+bool Output::isBlurBehindActive() const
+{
+    Q_D(const Output);
+    return d->blurBehindActive;
+}
+
+void Output::setBlurBehindActive(bool value)
+{
+    Q_D(Output);
+
+    if (d->blurBehindActive == value)
+        return;
+
+    d->blurBehindActive = value;
+    Q_EMIT blurBehindActiveChanged();
+}
+
 QPointF Output::mapToOutput(const QPointF &pt)
 {
     QPointF pos(geometry().topLeft());
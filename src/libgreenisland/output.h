@@ -35,6 +35,7 @@
 
 namespace GreenIsland {
 
+class BlurDamageTracker;
 class Compositor;
 class OutputPrivate;
 class ScreenManagerPrivate;
@@ -45,6 +46,7 @@ class GREENISLAND_EXPORT Output : public QWaylandQuickOutput
     Q_PROPERTY(QString name READ name CONSTANT)
     Q_PROPERTY(int number READ number CONSTANT)
     Q_PROPERTY(bool primary READ isPrimary NOTIFY primaryChanged)
+    Q_PROPERTY(bool blurBehindActive READ isBlurBehindActive NOTIFY blurBehindActiveChanged)
 public:
     Output(Compositor *compositor, KScreen::Output *output);
     Output(Compositor *compositor, const KScreen::OutputPtr &output);
@@ -59,6 +61,9 @@ public:
 
     bool isPrimary() const;
 
+    // Whether any surface on this output wants blur or contrast behind
+    bool isBlurBehindActive() const;
+
     // Maps global coordinates to local space
     Q_INVOKABLE QPointF mapToOutput(const QPointF &pt);
 
@@ -67,14 +72,21 @@ public:
 
 Q_SIGNALS:
     void primaryChanged();
+    void blurBehindActiveChanged();
+
+    // Content behind a blur region has changed and
+    // the blurred copy must be rendered again
+    void blurBehindDamaged();
 
 private:
     Q_DECLARE_PRIVATE(Output)
     OutputPrivate *const d_ptr;
 
+    friend class BlurDamageTrackerPrivate;
     friend class ScreenManagerPrivate;
 
     void setPrimary(bool value);
+    void setBlurBehindActive(bool value);
 
     Q_PRIVATE_SLOT(d_func(), void _q_currentModeIdChanged())
     Q_PRIVATE_SLOT(d_func(), void _q_posChanged())
@@ -0,0 +1,352 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QMargins>
+#include <QtCore/QTimer>
+
+#include "compositor.h"
+#include "output.h"
+#include "outputlayout.h"
+
+namespace GreenIsland {
+
+/*
+ * OutputLayoutPrivate
+ */
+
+struct OutputLayoutEntry
+{
+    Output *output;
+    QRect geometry;
+    QRect availableGeometry;
+};
+
+struct OutputLayoutStrut
+{
+    Output *output;
+    Qt::Edge edge;
+    int size;
+};
+
+class OutputLayoutPrivate
+{
+public:
+    OutputLayoutPrivate(OutputLayout *self);
+
+    void rebuild();
+    int indexOf(Output *output) const;
+    void updateAvailableGeometry(Output *output);
+
+    void _q_outputGeometryChanged();
+    void _q_outputAvailableGeometryChanged();
+    void _q_outputDestroyed(QObject *object);
+
+    QList<Output *> outputs;
+
+    // Geometries are copied here when outputs change so that
+    // queries don't go through each output every time
+    QList<OutputLayoutEntry> entries;
+    QRect boundingRect;
+
+    QHash<QObject *, OutputLayoutStrut> struts;
+
+    // Most queries come from the pointer which stays on
+    // the same output for a long time
+    mutable int lastHit;
+
+    // Several outputs usually change at once when the
+    // configuration is applied, notify only once
+    QTimer *changeTimer;
+
+private:
+    Q_DECLARE_PUBLIC(OutputLayout)
+    OutputLayout *const q_ptr;
+};
+
+OutputLayoutPrivate::OutputLayoutPrivate(OutputLayout *self)
+    : lastHit(-1)
+    , q_ptr(self)
+{
+    changeTimer = new QTimer(self);
+    changeTimer->setSingleShot(true);
+    changeTimer->setInterval(0);
+    self->connect(changeTimer, SIGNAL(timeout()),
+                  self, SIGNAL(layoutChanged()));
+}
+
+void OutputLayoutPrivate::rebuild()
+{
+    entries.clear();
+    boundingRect = QRect();
+    lastHit = -1;
+
+    for (Output *output: outputs) {
+        OutputLayoutEntry entry;
+        entry.output = output;
+        entry.geometry = output->geometry();
+        entry.availableGeometry = output->availableGeometry();
+        entries.append(entry);
+
+        boundingRect |= entry.geometry;
+    }
+
+    changeTimer->start();
+}
+
+int OutputLayoutPrivate::indexOf(Output *output) const
+{
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries.at(i).output == output)
+            return i;
+    }
+
+    return -1;
+}
+
+void OutputLayoutPrivate::updateAvailableGeometry(Output *output)
+{
+    // Panels on the same edge usually sit side by side,
+    // reserve only the biggest one
+    QMargins margins;
+    for (const OutputLayoutStrut &strut: struts) {
+        if (strut.output != output)
+            continue;
+
+        switch (strut.edge) {
+        case Qt::LeftEdge:
+            margins.setLeft(qMax(margins.left(), strut.size));
+            break;
+        case Qt::TopEdge:
+            margins.setTop(qMax(margins.top(), strut.size));
+            break;
+        case Qt::RightEdge:
+            margins.setRight(qMax(margins.right(), strut.size));
+            break;
+        case Qt::BottomEdge:
+            margins.setBottom(qMax(margins.bottom(), strut.size));
+            break;
+        }
+    }
+
+    // Changing it will trigger a rebuild
+    QRect available = output->geometry().marginsRemoved(margins);
+    if (output->availableGeometry() != available)
+        output->setAvailableGeometry(available);
+}
+
+void OutputLayoutPrivate::_q_outputGeometryChanged()
+{
+    Q_Q(OutputLayout);
+
+    Output *output = qobject_cast<Output *>(q->sender());
+    if (output)
+        updateAvailableGeometry(output);
+    rebuild();
+}
+
+void OutputLayoutPrivate::_q_outputAvailableGeometryChanged()
+{
+    Q_Q(OutputLayout);
+
+    rebuild();
+
+    Output *output = qobject_cast<Output *>(q->sender());
+    if (output)
+        Q_EMIT q->availableGeometryChanged(output);
+}
+
+void OutputLayoutPrivate::_q_outputDestroyed(QObject *object)
+{
+    // The object is being destroyed, only use it as a key
+    Output *output = static_cast<Output *>(object);
+    QHash<QObject *, OutputLayoutStrut>::iterator it = struts.begin();
+    while (it != struts.end()) {
+        if (it.value().output == output)
+            it = struts.erase(it);
+        else
+            ++it;
+    }
+
+    if (outputs.removeOne(output))
+        rebuild();
+}
+
+/*
+ * OutputLayout
+ */
+
+OutputLayout::OutputLayout(Compositor *compositor)
+    : QObject(compositor)
+    , d_ptr(new OutputLayoutPrivate(this))
+{
+}
+
+OutputLayout::~OutputLayout()
+{
+    delete d_ptr;
+}
+
+QList<Output *> OutputLayout::outputs() const
+{
+    Q_D(const OutputLayout);
+    return d->outputs;
+}
+
+QRect OutputLayout::geometry() const
+{
+    Q_D(const OutputLayout);
+    return d->boundingRect;
+}
+
+Output *OutputLayout::outputAt(const QPointF &pt) const
+{
+    Q_D(const OutputLayout);
+
+    QPoint point = pt.toPoint();
+    if (!d->boundingRect.contains(point))
+        return Q_NULLPTR;
+
+    if (d->lastHit >= 0 && d->entries.at(d->lastHit).geometry.contains(point))
+        return d->entries.at(d->lastHit).output;
+
+    for (int i = 0; i < d->entries.size(); i++) {
+        if (d->entries.at(i).geometry.contains(point)) {
+            d->lastHit = i;
+            return d->entries.at(i).output;
+        }
+    }
+
+    return Q_NULLPTR;
+}
+
+Output *OutputLayout::mainOutputFor(const QRectF &rect) const
+{
+    Q_D(const OutputLayout);
+
+    // Find the output that contains the biggest part of the rectangle
+    Output *main = Q_NULLPTR;
+    qreal maxArea = 0;
+
+    for (const OutputLayoutEntry &entry: d->entries) {
+        QRectF intersection = QRectF(entry.geometry).intersected(rect);
+        if (!intersection.isValid())
+            continue;
+
+        qreal area = intersection.width() * intersection.height();
+        if (area >= maxArea) {
+            main = entry.output;
+            maxArea = area;
+        }
+    }
+
+    return main;
+}
+
+QList<Output *> OutputLayout::outputsFor(const QRectF &rect) const
+{
+    Q_D(const OutputLayout);
+
+    QList<Output *> list;
+    if (!rect.intersects(d->boundingRect))
+        return list;
+
+    for (const OutputLayoutEntry &entry: d->entries) {
+        if (rect.intersects(entry.geometry))
+            list.append(entry.output);
+    }
+
+    return list;
+}
+
+QRect OutputLayout::availableGeometry(Output *output) const
+{
+    Q_D(const OutputLayout);
+
+    int index = d->indexOf(output);
+    if (index < 0)
+        return QRect();
+    return d->entries.at(index).availableGeometry;
+}
+
+void OutputLayout::addOutput(Output *output)
+{
+    Q_D(OutputLayout);
+
+    if (!output || d->outputs.contains(output))
+        return;
+
+    d->outputs.append(output);
+    d->rebuild();
+
+    connect(output, SIGNAL(geometryChanged()),
+            this, SLOT(_q_outputGeometryChanged()));
+    connect(output, SIGNAL(availableGeometryChanged()),
+            this, SLOT(_q_outputAvailableGeometryChanged()));
+    connect(output, SIGNAL(destroyed(QObject*)),
+            this, SLOT(_q_outputDestroyed(QObject*)));
+}
+
+void OutputLayout::setStrut(QObject *owner, Output *output, Qt::Edge edge, int size)
+{
+    Q_D(OutputLayout);
+
+    if (!owner || !output)
+        return;
+
+    // Only recompute outputs affected by the change
+    Output *previousOutput = Q_NULLPTR;
+    if (d->struts.contains(owner)) {
+        const OutputLayoutStrut &strut = d->struts.value(owner);
+        if (strut.output == output && strut.edge == edge && strut.size == size)
+            return;
+        previousOutput = strut.output;
+    }
+
+    OutputLayoutStrut strut;
+    strut.output = output;
+    strut.edge = edge;
+    strut.size = qMax(size, 0);
+    d->struts.insert(owner, strut);
+
+    if (previousOutput && previousOutput != output)
+        d->updateAvailableGeometry(previousOutput);
+    d->updateAvailableGeometry(output);
+}
+
+void OutputLayout::removeStrut(QObject *owner)
+{
+    Q_D(OutputLayout);
+
+    if (!d->struts.contains(owner))
+        return;
+
+    Output *output = d->struts.take(owner).output;
+    d->updateAvailableGeometry(output);
+}
+
+}
+
+#include "moc_outputlayout.cpp"
@@ -0,0 +1,79 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef OUTPUTLAYOUT_H
+#define OUTPUTLAYOUT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QRect>
+
+namespace GreenIsland {
+
+class Compositor;
+class Output;
+class OutputLayoutPrivate;
+
+class OutputLayout : public QObject
+{
+    Q_OBJECT
+public:
+    explicit OutputLayout(Compositor *compositor);
+    ~OutputLayout();
+
+    QList<Output *> outputs() const;
+
+    // Bounding rectangle of all outputs
+    QRect geometry() const;
+
+    Output *outputAt(const QPointF &pt) const;
+    Output *mainOutputFor(const QRectF &rect) const;
+    QList<Output *> outputsFor(const QRectF &rect) const;
+
+    QRect availableGeometry(Output *output) const;
+
+    void addOutput(Output *output);
+
+    // Space reserved along an output edge, for example by a panel;
+    // the owner identifies the reservation so that it can be updated
+    void setStrut(QObject *owner, Output *output, Qt::Edge edge, int size);
+    void removeStrut(QObject *owner);
+
+Q_SIGNALS:
+    void layoutChanged();
+    void availableGeometryChanged(Output *output);
+
+private:
+    Q_DECLARE_PRIVATE(OutputLayout)
+    OutputLayoutPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_outputGeometryChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_outputAvailableGeometryChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_outputDestroyed(QObject *object))
+};
+
+}
+
+#endif // OUTPUTLAYOUT_H
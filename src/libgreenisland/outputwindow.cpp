@@ -24,8 +24,12 @@
  * $END_LICENSE$
  ***************************************************************************/
 
-#include <QtCore/QStandardPaths>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QMouseEvent>
+#include <QtQml/QQmlComponent>
 #include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlIncubationController>
 
 #include "compositor.h"
 #include "gldebug.h"
@@ -35,15 +39,20 @@
 #include "quicksurface.h"
 #include "windowview.h"
 #include "shellwindowview.h"
+#include "startupmonitor.h"
 
 #include "protocols/fullscreen-shell/fullscreenshellclient.h"
 
 namespace GreenIsland {
 
 OutputWindow::OutputWindow(Compositor *compositor)
-    : QQuickView()
+    : QQuickView(compositor->engine(), Q_NULLPTR)
     , m_compositor(compositor)
     , m_output(Q_NULLPTR)
+    , m_context(Q_NULLPTR)
+    , m_renderingEnabled(true)
+    , m_inputMagnification(1.0)
+    , m_inputMagnificationRadius(0)
 {
     // Setup window
     setColor(Qt::black);
@@ -53,6 +62,11 @@ OutputWindow::OutputWindow(Compositor *compositor)
     connect(this, &QQuickView::afterRendering,
             this, &OutputWindow::sendCallbacks);
 
+    // Startup is over when the first frame hits the screen
+    if (!StartupMonitor::instance()->isFinished())
+        connect(this, &QQuickView::frameSwapped,
+                this, &OutputWindow::firstFrameSwapped);
+
     // Show the window as soon as QML is loaded
     connect(this, &QQuickView::statusChanged,
             this, &OutputWindow::componentStatusChanged);
@@ -80,6 +94,22 @@ OutputWindow::OutputWindow(Compositor *compositor)
     }
 }
 
+OutputWindow::~OutputWindow()
+{
+    // Objects are incubated asynchronously with the controller of the
+    // first window that used the engine, hand it over to another one
+    // otherwise incubation would become synchronous
+    if (engine() && engine()->incubationController() == incubationController()) {
+        for (QWindow *window: QGuiApplication::topLevelWindows()) {
+            OutputWindow *outputWindow = qobject_cast<OutputWindow *>(window);
+            if (outputWindow && outputWindow != this && outputWindow->engine() == engine()) {
+                engine()->setIncubationController(outputWindow->incubationController());
+                break;
+            }
+        }
+    }
+}
+
 Output *OutputWindow::output() const
 {
     return m_output;
@@ -94,74 +124,183 @@ void OutputWindow::setOutput(Output *output)
     // Save output reference
     m_output = output;
 
-    // Make compositor instance available to QML
-    rootContext()->setContextProperty("compositor", m_compositor);
+    // The engine is shared by all outputs, each window has its
+    // own context to reference itself and the output
+    m_context = new QQmlContext(engine()->rootContext(), this);
+    m_context->setContextProperty("_greenisland_window", this);
+    m_context->setContextProperty("_greenisland_output", m_output);
 
-    // Add a context property to reference this window
-    rootContext()->setContextProperty("_greenisland_window", this);
+    // Create the shell for this output, the component is compiled in
+    // the background at startup and might not be ready yet
+    setResizeMode(QQuickView::SizeRootObjectToView);
+    QQmlComponent *component = m_compositor->shellComponent();
+    if (component->isLoading()) {
+        connect(component, &QQmlComponent::statusChanged,
+                this, &OutputWindow::createShell);
+        return;
+    }
+    createShell();
+}
 
-    // Add a context property to reference the output
-    rootContext()->setContextProperty("_greenisland_output", m_output);
+QPointF OutputWindow::pointerPosition() const
+{
+    return m_pointerPos;
+}
 
-    // Load QML and setup window
-    setResizeMode(QQuickView::SizeRootObjectToView);
-    if (Compositor::s_fixedPlugin.isEmpty()) {
-        qFatal("No plugin specified, cannot continue!");
-    } else {
-        qDebug() << "Loading" << Compositor::s_fixedPlugin << "plugin";
-
-        QString path = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                              QString("greenisland/%1/Compositor.qml").arg(Compositor::s_fixedPlugin));
-
-        // Load main file or bail out
-        if (QFile(path).exists(path))
-            setSource(path);
-        else
-            qFatal("Plugin \"%s\" is not valid, cannot continue!",
-                   qPrintable(Compositor::s_fixedPlugin));
+bool OutputWindow::isRenderingEnabled() const
+{
+    return m_renderingEnabled;
+}
+
+void OutputWindow::setRenderingEnabled(bool enabled)
+{
+    if (m_renderingEnabled == enabled)
+        return;
+
+    m_renderingEnabled = enabled;
+
+    // With an empty scene a black frame is rendered, views are hidden
+    // so that clients stop rendering and without frame callbacks they
+    // don't commit, hence nothing asks for another frame
+    contentItem()->setVisible(enabled);
+}
+
+void OutputWindow::setInputMagnification(qreal factor, const QPointF &center, qreal radius)
+{
+    m_inputMagnification = factor;
+    m_inputMagnificationCenter = center;
+    m_inputMagnificationRadius = radius;
+}
+
+void OutputWindow::createShell()
+{
+    QQmlComponent *component = m_compositor->shellComponent();
+    if (!component->isReady())
+        return;
+
+    disconnect(component, &QQmlComponent::statusChanged,
+               this, &OutputWindow::createShell);
+
+    QObject *rootObject = component->create(m_context);
+    if (!rootObject) {
+        for (const QQmlError &error: component->errors())
+            qWarning() << error;
+        qFatal("Unable to create the shell for output \"%s\", cannot continue!",
+               qPrintable(m_output->name()));
     }
+    setContent(component->url(), component, rootObject);
+    StartupMonitor::instance()->mark(QStringLiteral("output-window-created"));
+}
+
+QPointF OutputWindow::mapInputPosition(const QPointF &pos) const
+{
+    if (m_inputMagnification <= 1.0)
+        return pos;
+
+    // Inverse of what the magnifier does, outside the lens
+    // the screen is shown as is
+    QPointF delta = pos - m_inputMagnificationCenter;
+    if (m_inputMagnificationRadius > 0 &&
+            QPointF::dotProduct(delta, delta) > m_inputMagnificationRadius * m_inputMagnificationRadius)
+        return pos;
+    return m_inputMagnificationCenter + delta / m_inputMagnification;
+}
+
+QMouseEvent OutputWindow::mapMouseEvent(QMouseEvent *event) const
+{
+    QPointF pos = mapInputPosition(event->localPos());
+    QPointF offset = pos - event->localPos();
+
+    QMouseEvent mapped(event->type(), pos, pos, event->screenPos() + offset,
+                       event->button(), event->buttons(), event->modifiers());
+    mapped.setTimestamp(event->timestamp());
+    return mapped;
+}
+
+bool OutputWindow::event(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd:
+        if (m_inputMagnification > 1.0) {
+            QTouchEvent *touchEvent = static_cast<QTouchEvent *>(event);
+            QList<QTouchEvent::TouchPoint> points = touchEvent->touchPoints();
+            for (QTouchEvent::TouchPoint &point: points) {
+                QPointF offset = mapInputPosition(point.pos()) - point.pos();
+                point.setPos(point.pos() + offset);
+                point.setScenePos(point.scenePos() + offset);
+                point.setScreenPos(point.screenPos() + offset);
+            }
+            touchEvent->setTouchPoints(points);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return QQuickView::event(event);
 }
 
 void OutputWindow::keyPressEvent(QKeyEvent *event)
 {
-    m_compositor->setIdleInhibit(m_compositor->idleInhibit() + 1);
+    m_compositor->reportActivity();
 
     QQuickView::keyPressEvent(event);
 }
 
 void OutputWindow::keyReleaseEvent(QKeyEvent *event)
 {
-    m_compositor->setIdleInhibit(m_compositor->idleInhibit() - 1);
+    m_compositor->reportActivity();
 
     QQuickView::keyReleaseEvent(event);
 }
 
 void OutputWindow::mousePressEvent(QMouseEvent *event)
 {
-    m_compositor->setIdleInhibit(m_compositor->idleInhibit() + 1);
+    m_compositor->reportActivity();
 
-    QQuickView::mousePressEvent(event);
+    QMouseEvent mapped = mapMouseEvent(event);
+    QQuickView::mousePressEvent(&mapped);
+    event->setAccepted(mapped.isAccepted());
 }
 
 void OutputWindow::mouseReleaseEvent(QMouseEvent *event)
 {
-    m_compositor->setIdleInhibit(m_compositor->idleInhibit() - 1);
+    m_compositor->reportActivity();
 
-    QQuickView::mouseReleaseEvent(event);
+    QMouseEvent mapped = mapMouseEvent(event);
+    QQuickView::mouseReleaseEvent(&mapped);
+    event->setAccepted(mapped.isAccepted());
 }
 
 void OutputWindow::mouseMoveEvent(QMouseEvent *event)
 {
-    m_compositor->setState(Compositor::Active);
+    m_compositor->reportActivity();
+
+    // Where the pointer is on screen, not what it points to
+    if (m_pointerPos != event->localPos()) {
+        m_pointerPos = event->localPos();
+        Q_EMIT pointerPositionChanged();
+    }
 
-    QQuickView::mouseMoveEvent(event);
+    QMouseEvent mapped = mapMouseEvent(event);
+    QQuickView::mouseMoveEvent(&mapped);
+    event->setAccepted(mapped.isAccepted());
 }
 
 void OutputWindow::wheelEvent(QWheelEvent *event)
 {
-    m_compositor->setState(Compositor::Active);
-
-    QQuickView::wheelEvent(event);
+    m_compositor->reportActivity();
+
+    QPointF pos = mapInputPosition(event->posF());
+    QWheelEvent mapped(pos, event->globalPosF() + pos - event->posF(),
+                       event->pixelDelta(), event->angleDelta(),
+                       event->delta(), event->orientation(),
+                       event->buttons(), event->modifiers(), event->phase());
+    mapped.setTimestamp(event->timestamp());
+    QQuickView::wheelEvent(&mapped);
+    event->setAccepted(mapped.isAccepted());
 }
 
 void OutputWindow::printInfo()
@@ -171,13 +310,33 @@ void OutputWindow::printInfo()
 
 void OutputWindow::sendCallbacks()
 {
-    m_compositor->sendFrameCallbacks(m_compositor->surfaces());
+    // Hidden surfaces are served by the compositor at a lower rate,
+    // nothing is while the output is blank
+    if (!m_renderingEnabled)
+        return;
+    m_compositor->sendFrameCallbacks(m_compositor->visibleSurfaces());
+}
+
+void OutputWindow::firstFrameSwapped()
+{
+    disconnect(this, &QQuickView::frameSwapped,
+               this, &OutputWindow::firstFrameSwapped);
+
+    StartupMonitor *monitor = StartupMonitor::instance();
+    monitor->mark(QStringLiteral("first-frame"));
+    monitor->finish();
 }
 
 void OutputWindow::componentStatusChanged(const QQuickView::Status &status)
 {
-    if (status == QQuickView::Ready)
-        show();
+    if (status != QQuickView::Ready)
+        return;
+
+    // Outputs added while the compositor doesn't render are
+    // blank until it's back
+    setRenderingEnabled(m_compositor->state() == Compositor::Active ||
+                        m_compositor->state() == Compositor::Idle);
+    show();
 }
 
 }
@@ -31,6 +31,8 @@
 
 #include <greenisland/greenisland_export.h>
 
+class QQmlContext;
+
 namespace GreenIsland {
 
 class Compositor;
@@ -39,15 +41,35 @@ class Output;
 class GREENISLAND_EXPORT OutputWindow : public QQuickView
 {
     Q_OBJECT
+    Q_PROPERTY(QPointF pointerPosition READ pointerPosition NOTIFY pointerPositionChanged)
 public:
     explicit OutputWindow(Compositor *compositor);
+    ~OutputWindow();
 
     Compositor *compositor() const;
 
     Output *output() const;
     void setOutput(Output *output);
 
+    // Last pointer position over this window, in local coordinates
+    QPointF pointerPosition() const;
+
+    // Blank the output while the compositor doesn't render, the window
+    // stays visible so that input can still wake the compositor up
+    bool isRenderingEnabled() const;
+    void setRenderingEnabled(bool enabled);
+
+    // Map pointer and touch input to what the screen magnifier shows,
+    // a factor of 1 turns it off and a radius of 0 means that the
+    // whole output is magnified instead of a lens
+    Q_INVOKABLE void setInputMagnification(qreal factor, const QPointF &center, qreal radius);
+
+Q_SIGNALS:
+    void pointerPositionChanged();
+
 protected:
+    bool event(QEvent *event);
+
     void keyPressEvent(QKeyEvent *event);
     void keyReleaseEvent(QKeyEvent *event);
 
@@ -60,10 +82,22 @@ protected:
 private:
     Compositor *m_compositor;
     Output *m_output;
+    QQmlContext *m_context;
+    QPointF m_pointerPos;
+    bool m_renderingEnabled;
+    qreal m_inputMagnification;
+    QPointF m_inputMagnificationCenter;
+    qreal m_inputMagnificationRadius;
+
+    void createShell();
+
+    QPointF mapInputPosition(const QPointF &pos) const;
+    QMouseEvent mapMouseEvent(QMouseEvent *event) const;
 
 private Q_SLOTS:
     void printInfo();
     void sendCallbacks();
+    void firstFrameSwapped();
     void componentStatusChanged(const QQuickView::Status &status);
 };
 
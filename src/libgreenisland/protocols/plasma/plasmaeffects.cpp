@@ -70,8 +70,9 @@ void PlasmaEffects::effects_slide(Resource *resource,
         return;
     }
 
-    QPointF ptFrom;
+    // Slide along one axis from just outside the output edge
     QPointF ptTo(x, y);
+    QPointF ptFrom(ptTo);
 
     switch (from) {
     case location_none:
@@ -79,22 +80,20 @@ void PlasmaEffects::effects_slide(Resource *resource,
         ptFrom.setY(output->geometry().height() / 2);
         break;
     case location_left:
-        ptFrom = QPointF(-surface->size().width(), 0);
+        ptFrom.setX(-surface->size().width());
         break;
     case location_top:
-        ptFrom = QPointF(0, -surface->size().height());
+        ptFrom.setY(-surface->size().height());
         break;
     case location_right:
-        ptFrom = QPointF(output->geometry().width() +
-                         surface->size().width(), 0);
+        ptFrom.setX(output->geometry().width());
         break;
     case location_bottom:
-        ptFrom = QPointF(0, output->geometry().height() +
-                         surface->size().height());
+        ptFrom.setY(output->geometry().height());
         break;
     }
 
-    // TODO: Move window from ptFrom to ptTo
+    surface->slide(output, ptFrom, ptTo);
 }
 
 void PlasmaEffects::effects_set_blur_behind_region(Resource *resource,
@@ -110,10 +109,11 @@ void PlasmaEffects::effects_set_blur_behind_region(Resource *resource,
         return;
     }
 
-    QtWayland::Region *r = QtWayland::Region::fromResource(regionResource);
-    r->region();
-
-    // TODO: Set blur behind region on views
+    // A null region disables blur behind
+    QRegion region;
+    if (regionResource)
+        region = QtWayland::Region::fromResource(regionResource)->region();
+    surface->setBlurRegion(region);
 }
 
 void PlasmaEffects::effects_set_contrast_region(Resource *resource,
@@ -132,13 +132,16 @@ void PlasmaEffects::effects_set_contrast_region(Resource *resource,
         return;
     }
 
-    QtWayland::Region *r = QtWayland::Region::fromResource(regionResource);
-    r->region();
+    // A null region disables the effect and parameters are ignored
+    if (!regionResource) {
+        surface->setContrast(QRegion(), 1.0, 1.0, 1.0);
+        return;
+    }
 
-    // TODO: Set contrast on views
-    Q_UNUSED(contrast);
-    Q_UNUSED(intensity);
-    Q_UNUSED(saturation);
+    // Parameters range from 0 to 255, map them to a 0-2 factor
+    QRegion region = QtWayland::Region::fromResource(regionResource)->region();
+    surface->setContrast(region, contrast / 127.5,
+                         intensity / 127.5, saturation / 127.5);
 }
 
 }
@@ -29,6 +29,7 @@
 
 #include "compositor.h"
 #include "output.h"
+#include "outputlayout.h"
 #include "plasmasurface.h"
 #include "quicksurface.h"
 #include "shellwindowview.h"
@@ -49,6 +50,9 @@ PlasmaSurface::PlasmaSurface(PlasmaShell *shell, QuickSurface *surface,
     , m_role(ShellWindowView::NoneRole)
     , m_deleting(true)
 {
+    // Shell surfaces enter and leave outputs
+    m_surface->setShellRole(true);
+
     // Create a view for the first output
     Output *output = qobject_cast<Output *>(m_surface->compositor()->outputs().at(0));
     m_view = new ShellWindowView(m_surface, output);
@@ -61,10 +65,33 @@ PlasmaSurface::PlasmaSurface(PlasmaShell *shell, QuickSurface *surface,
             return;
         m_surface->setMapped(hasBuffer);
     });
+
+    // Panels reserve space on their output
+    connect(m_surface, &QuickSurface::globalGeometryChanged, this, [=]() {
+        updateStrut();
+    });
+    connect(m_surface, &QuickSurface::sizeChanged, this, [=]() {
+        updateStrut();
+    });
+    connect(m_surface, &QuickSurface::mapped, this, [=]() {
+        updateStrut();
+    });
+    connect(m_surface, &QuickSurface::unmapped, this, [=]() {
+        updateStrut();
+    });
+    connect(m_view, &ShellWindowView::flagsChanged, this, [=]() {
+        updateStrut();
+    });
+    connect(m_view, &ShellWindowView::outputChanged, this, [=]() {
+        updateStrut();
+    });
 }
 
 PlasmaSurface::~PlasmaSurface()
 {
+    // Give space back to windows
+    m_compositor->outputLayout()->removeStrut(this);
+
     // Don't destroy the resource if the destructor is called
     // from surface_destroy_resource()
     if (!m_deleting) {
@@ -160,6 +187,47 @@ QString PlasmaSurface::role2String(const ShellWindowView::Role &role)
     return QStringLiteral("None");
 }
 
+void PlasmaSurface::updateStrut()
+{
+    OutputLayout *layout = m_compositor->outputLayout();
+
+    // Only panels that can't be covered by windows reserve space
+    const ShellWindowView::Flags coverFlags = ShellWindowView::PanelAutoHide |
+            ShellWindowView::PanelWindowsCanCover |
+            ShellWindowView::PanelWindowsGoBelow;
+    Output *output = m_view->output();
+    QRectF geometry = m_surface->globalGeometry();
+    if (m_role != ShellWindowView::PanelRole || (m_view->flags() & coverFlags) ||
+            !output || !m_surface->isMapped() || !geometry.isValid()) {
+        layout->removeStrut(this);
+        return;
+    }
+
+    // Reserve space along the edge the panel is closer to
+    QRectF outputGeometry(output->geometry());
+    Qt::Edge edge;
+    qreal size;
+    if (geometry.width() >= geometry.height()) {
+        if (geometry.center().y() < outputGeometry.center().y()) {
+            edge = Qt::TopEdge;
+            size = geometry.bottom() - outputGeometry.top();
+        } else {
+            edge = Qt::BottomEdge;
+            size = outputGeometry.bottom() - geometry.top();
+        }
+    } else {
+        if (geometry.center().x() < outputGeometry.center().x()) {
+            edge = Qt::LeftEdge;
+            size = geometry.right() - outputGeometry.left();
+        } else {
+            edge = Qt::RightEdge;
+            size = outputGeometry.right() - geometry.left();
+        }
+    }
+
+    layout->setStrut(this, output, edge, qRound(size));
+}
+
 void PlasmaSurface::surface_destroy_resource(Resource *resource)
 {
     Q_UNUSED(resource);
@@ -229,6 +297,7 @@ void PlasmaSurface::surface_set_role(Resource *resource,
     // Set role
     m_role = role;
     m_view->setRole(m_role);
+    updateStrut();
 
     // Show splash layer when a splash role is set
     if (m_role == ShellWindowView::SplashRole)
@@ -65,6 +65,8 @@ private:
     ShellWindowView::Role wl2Role(uint32_t role);
     QString role2String(const ShellWindowView::Role &role);
 
+    void updateStrut();
+
     ShellWindowView::Flags wl2Flags(uint32_t wlFlags);
 
     void surface_destroy_resource(Resource *resource) Q_DECL_OVERRIDE;
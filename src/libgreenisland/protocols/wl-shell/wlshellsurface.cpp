@@ -31,7 +31,9 @@
 #include <QtCompositor/private/qwlpointer_p.h>
 #include <QtCompositor/private/qwlsurface_p.h>
 
+#include "compositor.h"
 #include "output.h"
+#include "outputlayout.h"
 #include "quicksurface.h"
 #include "wlshellsurface.h"
 #include "wlshellsurfacemovegrabber.h"
@@ -58,8 +60,12 @@ WlShellSurface::WlShellSurface(WlShell *shell, QuickSurface *surface,
     , m_popupSerial()
     , m_state(Normal)
     , m_prevState(Normal)
+    , m_maximizedOutput(Q_NULLPTR)
     , m_deleting(false)
 {
+    // Shell surfaces enter and leave outputs
+    m_surface->setShellRole(true);
+
     // Create a view for the first output
     Output *output = qobject_cast<Output *>(m_surface->compositor()->outputs().at(0));
     m_view = new WindowView(m_surface, output);
@@ -87,6 +93,11 @@ WlShellSurface::WlShellSurface(WlShell *shell, QuickSurface *surface,
             m_popupGrabber->m_client = Q_NULLPTR;
         }
     });
+
+    // Follow work area changes when maximized
+    Compositor *compositor = static_cast<Compositor *>(m_surface->compositor());
+    connect(compositor->outputLayout(), &OutputLayout::availableGeometryChanged,
+            this, &WlShellSurface::updateMaximizedGeometry);
 }
 
 WlShellSurface::~WlShellSurface()
@@ -399,6 +410,7 @@ void WlShellSurface::shell_surface_set_maximized(Resource *resource, wl_resource
     // Set state
     m_prevState = m_state;
     m_state = Maximized;
+    m_maximizedOutput = output;
     m_surface->setState(static_cast<QuickSurface::State>(m_state));
 }
 
@@ -416,4 +428,18 @@ void WlShellSurface::shell_surface_set_class(Resource *resource, const QString &
     setSurfaceClassName(class_);
 }
 
+void WlShellSurface::updateMaximizedGeometry(Output *output)
+{
+    if (m_state != Maximized || output != m_maximizedOutput)
+        return;
+
+    // Bother the client only if the window has to change
+    QRect geometry = output->availableGeometry();
+    if (m_surface->globalGeometry() == QRectF(geometry))
+        return;
+
+    m_surface->setGlobalPosition(QPointF(geometry.topLeft()));
+    requestResize(geometry.size());
+}
+
 }
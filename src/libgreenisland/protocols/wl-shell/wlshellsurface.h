@@ -38,6 +38,7 @@ class QWaylandInputDevice;
 
 namespace GreenIsland {
 
+class Output;
 class QuickSurface;
 class WindowView;
 class WlShellSurfaceMoveGrabber;
@@ -99,12 +100,14 @@ private:
     State m_state;
     State m_prevState;
     QRectF m_prevGlobalGeometry;
+    QWaylandOutput *m_maximizedOutput;
 
     bool m_deleting;
 
     void ping(uint32_t serial);
     void moveWindow(QWaylandInputDevice *device);
     void requestResize(const QSize &size);
+    void updateMaximizedGeometry(Output *output);
 
 
     void shell_surface_destroy_resource(Resource *resource) Q_DECL_OVERRIDE;
@@ -50,7 +50,8 @@ void WlShellSurfaceMoveGrabber::motion(uint32_t time)
     QCursor cursor(Qt::ClosedHandCursor);
     QGuiApplication::setOverrideCursor(cursor);
 
-    // Determine pointer coordinates
+    // Determine pointer coordinates, windows are moved once
+    // per frame no matter how many motion events we get
     QPointF pt(m_pointer->position() - m_offset);
 
     // Top level windows
@@ -65,7 +66,7 @@ void WlShellSurfaceMoveGrabber::motion(uint32_t time)
                 m_shellSurface->surface()->setGlobalPosition(pt);
             }
         } else {
-            m_shellSurface->surface()->setGlobalPosition(pt);
+            m_shellSurface->surface()->requestGlobalPosition(pt);
         }
     }
 
@@ -73,7 +74,7 @@ void WlShellSurfaceMoveGrabber::motion(uint32_t time)
     // because it's a child QML item
     WindowView *parentView = m_shellSurface->parentView();
     if (parentView && parentView->surface())
-        parentView->surface()->setGlobalPosition(pt - m_shellSurface->transientOffset());
+        parentView->surface()->requestGlobalPosition(pt - m_shellSurface->transientOffset());
 }
 
 void WlShellSurfaceMoveGrabber::button(uint32_t time, Qt::MouseButton button, uint32_t state)
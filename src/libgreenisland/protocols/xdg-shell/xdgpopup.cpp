@@ -29,6 +29,7 @@
 #include <QtCompositor/private/qwlpointer_p.h>
 #include <QtCompositor/private/qwlsurface_p.h>
 
+#include "quicksurface.h"
 #include "xdgpopup.h"
 #include "xdgpopupgrabber.h"
 
@@ -51,6 +52,11 @@ XdgPopup::XdgPopup(XdgShell *shell, QWaylandSurface *parent, QWaylandSurface *su
     // Set surface type
     setSurfaceType(QWaylandSurface::Popup);
 
+    // Shell surfaces enter and leave outputs
+    QuickSurface *quickSurface = qobject_cast<QuickSurface *>(m_surface);
+    if (quickSurface)
+        quickSurface->setShellRole(true);
+
     // Surface mapping and unmapping
     connect(m_surface, &QWaylandSurface::configure, [=](bool hasBuffer) {
         // Map or unmap the surface
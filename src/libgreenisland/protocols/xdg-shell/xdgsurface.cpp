@@ -33,7 +33,9 @@
 #include <QtCompositor/private/qwlpointer_p.h>
 #include <QtCompositor/private/qwlsurface_p.h>
 
+#include "compositor.h"
 #include "output.h"
+#include "outputlayout.h"
 #include "quicksurface.h"
 #include "windowview.h"
 #include "xdgsurface.h"
@@ -56,7 +58,12 @@ XdgSurface::XdgSurface(XdgShell *shell, QuickSurface *surface,
     , m_resizeGrabber(Q_NULLPTR)
     , m_minimized(false)
     , m_state(Normal)
+    , m_savedState(Normal)
+    , m_maximizedOutput(Q_NULLPTR)
 {
+    // Shell surfaces enter and leave outputs
+    m_surface->setShellRole(true);
+
     // Destroy this when the surface is destroyed
     connect(surface, &QuickSurface::surfaceDestroyed, [=]() {
         m_surface = Q_NULLPTR;
@@ -89,6 +96,11 @@ XdgSurface::XdgSurface(XdgShell *shell, QuickSurface *surface,
         changes.resizing = false;
         requestConfigure(changes);
     });
+
+    // Follow work area changes when maximized
+    Compositor *compositor = static_cast<Compositor *>(m_surface->compositor());
+    connect(compositor->outputLayout(), &OutputLayout::availableGeometryChanged,
+            this, &XdgSurface::updateMaximizedGeometry);
 }
 
 uint32_t XdgSurface::nextSerial() const
@@ -368,7 +380,8 @@ void XdgSurface::surface_ack_configure(Resource *resource, uint32_t serial)
     Changes changes = m_pendingChanges.take(serial);
 
     // Set state
-    if (changes.newState) {
+    State previousState = m_state;
+    if (changes.newState && changes.state != m_state) {
         m_savedState = m_state;
         m_state = changes.state;
 
@@ -399,8 +412,10 @@ void XdgSurface::surface_ack_configure(Resource *resource, uint32_t serial)
         changed = true;
     }
     if (changed) {
-        // Save global space geometry and set position
-        m_savedGeometry = m_surface->globalGeometry();
+        // Save global space geometry, only normal windows have a
+        // geometry worth restoring later, and set position
+        if (previousState == Normal)
+            m_savedGeometry = m_surface->globalGeometry();
         m_surface->setGlobalPosition(geometry.topLeft());
     }
 }
@@ -429,7 +444,8 @@ void XdgSurface::surface_set_maximized(Resource *resource)
         return;
 
     // New global space geometry
-    QRectF geometry = m_view->mainOutput()->availableGeometry();
+    m_maximizedOutput = m_view->mainOutput();
+    QRectF geometry = m_maximizedOutput->availableGeometry();
 
     // Ask for a resize on the output where the biggest part of the window
     // is mapped and set pending state, we'll complete the operation as
@@ -519,6 +535,27 @@ void XdgSurface::surface_set_minimized(Resource *resource)
         window()->setVisible(false);
 }
 
+void XdgSurface::updateMaximizedGeometry(Output *output)
+{
+    if (!m_surface || m_state != Maximized || output != m_maximizedOutput)
+        return;
+
+    // Bother the client only if the window has to change
+    QRectF geometry = output->availableGeometry();
+    if (m_surface->globalGeometry() == geometry)
+        return;
+
+    Changes changes;
+    changes.newState = true;
+    changes.active = m_view->hasFocus();
+    changes.state = Maximized;
+    changes.moving = true;
+    changes.resizing = true;
+    changes.position = geometry.topLeft();
+    changes.size = geometry.size();
+    requestConfigure(changes);
+}
+
 }
 
 #include "moc_xdgsurface.cpp"
@@ -37,6 +37,7 @@ class QWaylandInputDevice;
 
 namespace GreenIsland {
 
+class Output;
 class QuickSurface;
 class WindowView;
 class XdgSurfaceMoveGrabber;
@@ -127,10 +128,13 @@ private:
     State m_savedState;
     QRectF m_savedGeometry;
 
+    Output *m_maximizedOutput;
+
     QMap<uint32_t, Changes> m_pendingChanges;
 
 
     void moveWindow(QWaylandInputDevice *device);
+    void updateMaximizedGeometry(Output *output);
 
 
     void surface_destroy(Resource *resource) Q_DECL_OVERRIDE;
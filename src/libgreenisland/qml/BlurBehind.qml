@@ -0,0 +1,119 @@
+/****************************************************************************
+ * This file is part of Hawaii Shell.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+import QtQuick 2.0
+import GreenIsland 1.0
+
+/*
+ * Shows the blurred copy of what's behind a window, limited to
+ * the blur region requested by the client, and applies contrast
+ * to what's behind the contrast region.
+ */
+
+Item {
+    property var window
+    property var cache
+    readonly property var surface: window && window.child ? window.child.surface : null
+
+    // Windows that are part of the blurred copy would see themselves
+    readonly property bool active: surface !== null && cache && cache.active &&
+                                   !isInside(window, cache.sourceItem)
+
+    id: blurBehind
+    visible: active
+
+    function isInside(item, ancestor) {
+        for (var p = item ? item.parent : null; p; p = p.parent) {
+            if (p === ancestor)
+                return true;
+        }
+        return false;
+    }
+
+    // Unlike mapToItem() this binds to the position of every ancestor,
+    // the cache fills the screen view so it's the common root
+    function positionInCache(item) {
+        var x = 0, y = 0;
+        for (var p = item; p && p !== cache.parent; p = p.parent) {
+            x += p.x;
+            y += p.y;
+        }
+        return Qt.point(x, y);
+    }
+
+    Repeater {
+        model: blurBehind.active && blurBehind.surface.blurBehind ? blurBehind.surface.blurRects : null
+
+        ShaderEffect {
+            readonly property point origin: blurBehind.positionInCache(this)
+
+            x: modelData.x
+            y: modelData.y
+            width: modelData.width
+            height: modelData.height
+
+            property variant source: blurBehind.cache.texture
+            property rect sourceRect: Qt.rect(origin.x / blurBehind.cache.width,
+                                              origin.y / blurBehind.cache.height,
+                                              width / blurBehind.cache.width,
+                                              height / blurBehind.cache.height)
+
+            vertexShader: "
+                uniform highp mat4 qt_Matrix;
+                uniform highp vec4 sourceRect;
+                attribute highp vec4 qt_Vertex;
+                attribute highp vec2 qt_MultiTexCoord0;
+                varying highp vec2 qt_TexCoord0;
+
+                void main() {
+                    qt_TexCoord0 = sourceRect.xy + qt_MultiTexCoord0 * sourceRect.zw;
+                    gl_Position = qt_Matrix * qt_Vertex;
+                }"
+
+            fragmentShader: "
+                uniform sampler2D source;
+                uniform lowp float qt_Opacity;
+                varying highp vec2 qt_TexCoord0;
+
+                void main() {
+                    gl_FragColor = texture2D(source, qt_TexCoord0) * qt_Opacity;
+                }"
+        }
+    }
+
+    // Contrast is applied to the blurred copy when both are requested
+    ContrastRegion {
+        readonly property point origin: blurBehind.positionInCache(this)
+
+        anchors.fill: parent
+        surface: blurBehind.surface
+        source: blurBehind.surface && blurBehind.surface.blurBehind
+                ? blurBehind.cache.texture : blurBehind.cache.sourceTexture
+        sourceRect: Qt.rect(-origin.x, -origin.y,
+                            blurBehind.cache.width, blurBehind.cache.height)
+        visible: blurBehind.active && blurBehind.surface.contrastBehind
+    }
+}
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * This file is part of Hawaii Shell.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+import QtQuick 2.0
+
+/*
+ * Blurred copy of what's behind shell windows on this output.
+ *
+ * The source is copied at half resolution and blurred with the
+ * dual Kawase filter: two passes going down to 1/8 of the output
+ * size and two passes going back up.  Each pass samples only a
+ * few texels so the cost is a fraction of a Gaussian at full size.
+ *
+ * The copy is not live, it's rendered again only when the
+ * compositor reports damage behind a blur region.
+ */
+
+Item {
+    property Item sourceItem
+    property real offset: 1.5
+    readonly property bool active: _greenisland_output.blurBehindActive
+    readonly property alias texture: up2Source
+    readonly property alias sourceTexture: capture
+
+    id: cache
+
+    // Render a fresh copy with the next frame
+    function invalidate() {
+        if (active)
+            capture.scheduleUpdate();
+    }
+
+    onActiveChanged: invalidate()
+    onWidthChanged: invalidate()
+    onHeightChanged: invalidate()
+
+    Connections {
+        target: _greenisland_output
+        onBlurBehindDamaged: cache.invalidate()
+    }
+
+    ShaderEffectSource {
+        id: capture
+        sourceItem: cache.active ? cache.sourceItem : null
+        textureSize: Qt.size(Math.ceil(cache.width / 2), Math.ceil(cache.height / 2))
+        live: false
+        smooth: true
+        visible: false
+    }
+
+    ShaderEffect {
+        id: down1
+        width: Math.ceil(cache.width / 4)
+        height: Math.ceil(cache.height / 4)
+        property variant source: capture
+        property size halfpixel: Qt.size(0.5 / width, 0.5 / height)
+        property real offset: cache.offset
+        fragmentShader: cache.downShader
+        visible: false
+    }
+
+    ShaderEffectSource {
+        id: down1Source
+        sourceItem: down1
+        smooth: true
+        visible: false
+    }
+
+    ShaderEffect {
+        id: down2
+        width: Math.ceil(cache.width / 8)
+        height: Math.ceil(cache.height / 8)
+        property variant source: down1Source
+        property size halfpixel: Qt.size(0.5 / width, 0.5 / height)
+        property real offset: cache.offset
+        fragmentShader: cache.downShader
+        visible: false
+    }
+
+    ShaderEffectSource {
+        id: down2Source
+        sourceItem: down2
+        smooth: true
+        visible: false
+    }
+
+    ShaderEffect {
+        id: up1
+        width: Math.ceil(cache.width / 4)
+        height: Math.ceil(cache.height / 4)
+        property variant source: down2Source
+        property size halfpixel: Qt.size(0.5 / width, 0.5 / height)
+        property real offset: cache.offset
+        fragmentShader: cache.upShader
+        visible: false
+    }
+
+    ShaderEffectSource {
+        id: up1Source
+        sourceItem: up1
+        smooth: true
+        visible: false
+    }
+
+    ShaderEffect {
+        id: up2
+        width: Math.ceil(cache.width / 2)
+        height: Math.ceil(cache.height / 2)
+        property variant source: up1Source
+        property size halfpixel: Qt.size(0.5 / width, 0.5 / height)
+        property real offset: cache.offset
+        fragmentShader: cache.upShader
+        visible: false
+    }
+
+    ShaderEffectSource {
+        id: up2Source
+        sourceItem: up2
+        smooth: true
+        visible: false
+    }
+
+    readonly property string downShader: "
+        uniform sampler2D source;
+        uniform highp vec2 halfpixel;
+        uniform highp float offset;
+        varying highp vec2 qt_TexCoord0;
+
+        void main() {
+            highp vec2 uv = qt_TexCoord0;
+            lowp vec4 sum = texture2D(source, uv) * 4.0;
+            sum += texture2D(source, uv - halfpixel * offset);
+            sum += texture2D(source, uv + halfpixel * offset);
+            sum += texture2D(source, uv + vec2(halfpixel.x, -halfpixel.y) * offset);
+            sum += texture2D(source, uv - vec2(halfpixel.x, -halfpixel.y) * offset);
+            gl_FragColor = sum / 8.0;
+        }"
+
+    readonly property string upShader: "
+        uniform sampler2D source;
+        uniform highp vec2 halfpixel;
+        uniform highp float offset;
+        varying highp vec2 qt_TexCoord0;
+
+        void main() {
+            highp vec2 uv = qt_TexCoord0;
+            lowp vec4 sum = texture2D(source, uv + vec2(-halfpixel.x * 2.0, 0.0) * offset);
+            sum += texture2D(source, uv + vec2(-halfpixel.x, halfpixel.y) * offset) * 2.0;
+            sum += texture2D(source, uv + vec2(0.0, halfpixel.y * 2.0) * offset);
+            sum += texture2D(source, uv + vec2(halfpixel.x, halfpixel.y) * offset) * 2.0;
+            sum += texture2D(source, uv + vec2(halfpixel.x * 2.0, 0.0) * offset);
+            sum += texture2D(source, uv + vec2(halfpixel.x, -halfpixel.y) * offset) * 2.0;
+            sum += texture2D(source, uv + vec2(0.0, -halfpixel.y * 2.0) * offset);
+            sum += texture2D(source, uv + vec2(-halfpixel.x, -halfpixel.y) * offset) * 2.0;
+            gl_FragColor = sum / 12.0;
+        }"
+}
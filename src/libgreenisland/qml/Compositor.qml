@@ -33,38 +33,22 @@ import "screen"
 
 Item {
     readonly property alias screenView: screenView
-    readonly property alias surfaceModel: surfaceModel
+    readonly property var surfaceModel: compositor.surfaceModel.outputModel(_greenisland_output)
 
     id: compositorRoot
 
-    Timer {
-        id: idleTimer
-        //interval: compositor.idleInterval
-        onIntervalChanged: {
-            if (running)
-                restart();
-        }
-    }
-
-    ListModel {
-        id: surfaceModel
-    }
-
     Connections {
         target: compositor
-        onIdleInhibitResetRequested: compositor.idleInhibit = 0
-        onIdleTimerStartRequested: idleTimer.running = true
-        onIdleTimerStopRequested: idleTimer.running = false
         onIdle: {
             // Fade the desktop out
             screenView.layers.splash.opacity = 1.0;
-
-            // Lock the session
-            compositor.lockSession();
         }
         onWake: {
-            // Unlock the session
-            compositor.unlockSession();
+            // Fade the desktop in
+            screenView.layers.splash.opacity = 0.0;
+
+            // Bring user layer up
+            screenView.setCurrentLayer("user");
         }
         onFadeIn: {
             // Fade the desktop in
@@ -97,21 +81,6 @@ Item {
 
             // Bring user layer up
             screenView.setCurrentLayer("user");
-
-            // Start idle timer
-            idleTimer.running = true
-        }
-        onWorkspaceAdded: {
-            // Add a new workspace
-            screenView.workspacesView.add();
-        }
-        onWorkspaceRemoved: {
-            // Remove workspace
-            screenView.workspacesView.remove(index);
-        }
-        onWorkspaceSelected: {
-            // Select workspace
-            screenView.workspacesView.select(index);
         }
         onSurfaceMapped: {
             // A surface was mapped
@@ -127,6 +96,14 @@ Item {
         }
     }
 
+    Connections {
+        target: compositor.workspaceManager
+        onSurfaceAssigned: {
+            // Move the window to its new workspace
+            WindowManagement.surfaceAssigned(surface, index);
+        }
+    }
+
     /*
      * Components
      */
@@ -24,7 +24,7 @@
  * $END_LICENSE$
  ***************************************************************************/
 
-import QtQuick 2.0
+import QtQuick 2.2
 import QtCompositor 1.0
 import GreenIsland 1.0
 
@@ -34,6 +34,18 @@ Item {
     property var role: child.surface.windowProperties.role
     property var transientChildren: null
 
+    // Show a downsampled copy refreshed at most 10 times per second,
+    // used while the window is shrunk by overviews and switchers
+    property bool thumbnailMode: false
+
+    // Evicted textures are gone until the window is shown again,
+    // the thumbnail keeps showing the last copy or a snapshot
+    readonly property bool showThumbnail: thumbnailMode || (child && child.surface.textureEvicted)
+
+    // Clients keep drawing while shown or while a cached
+    // copy of their workspace is shown by the overview
+    readonly property bool renderingEnabled: visible || (parent !== null && parent.trackDamage === true)
+
     id: waylandWindow
     opacity: 1.0
     rotation: {
@@ -56,14 +68,33 @@ Item {
 
         return 0;
     }
-    onVisibleChanged: {
+    onScaleChanged: {
+        // Size of the copy depends on the scale
+        if (thumbnailMode)
+            thumbnail.refresh();
+    }
+    onRenderingEnabledChanged: {
         if (child)
-            child.surface.clientRenderingEnabled = visible;
+            child.surface.clientRenderingEnabled = renderingEnabled;
+    }
+
+    BlurBehind {
+        anchors.fill: parent
+        window: waylandWindow
+        cache: compositorRoot.screenView.blurCache
     }
 
     SurfaceRenderer {
         anchors.fill: parent
         source: child
+        visible: !waylandWindow.showThumbnail
+    }
+
+    WindowThumbnail {
+        id: thumbnail
+        anchors.fill: parent
+        source: waylandWindow.showThumbnail ? child : null
+        visible: waylandWindow.showThumbnail
     }
 
     Connections {
@@ -72,6 +103,24 @@ Item {
             waylandWindow.width = child.surface.size.width;
             waylandWindow.height = child.surface.size.height;
         }
+        onSlideRequested: {
+            // Animators run on the render thread and are driven
+            // by the output vsync, not blocked by JavaScript
+            var localFrom = _greenisland_output.mapToOutput(from);
+            var localTo = _greenisland_output.mapToOutput(to);
+            slideAnimation.stop();
+            slideX.from = localFrom.x;
+            slideX.to = localTo.x;
+            slideY.from = localFrom.y;
+            slideY.to = localTo.y;
+            slideAnimation.start();
+        }
+        onDamaged: {
+            // Workspace thumbnails refresh only when something changed
+            var workspace = waylandWindow.parent;
+            if (workspace && workspace.trackDamage)
+                workspace.markDamaged();
+        }
         onPong: {
             // Surface replied with a pong this means it's responsive
             pingPongTimer.running = false;
@@ -79,6 +128,24 @@ Item {
         }
     }
 
+    ParallelAnimation {
+        id: slideAnimation
+
+        XAnimator {
+            id: slideX
+            target: waylandWindow
+            easing.type: Easing.OutQuad
+            duration: 250
+        }
+
+        YAnimator {
+            id: slideY
+            target: waylandWindow
+            easing.type: Easing.OutQuad
+            duration: 250
+        }
+    }
+
     Timer {
         id: pingPongTimer
         interval: 200
@@ -24,6 +24,29 @@
  * $END_LICENSE$
  ***************************************************************************/
 
+/*
+ * Components
+ */
+
+// Window components are compiled once and shared by all windows
+var clientWindowComponent = null;
+var shellWindowComponent = null;
+
+// Surfaces whose window representation is being incubated
+// and the incubator for each of them, in the same order
+var pendingSurfaces = [];
+var pendingIncubators = [];
+
+function loadComponent(component, url) {
+    if (component === null)
+        component = Qt.createComponent(url);
+    if (component.status !== Component.Ready) {
+        console.error(component.errorString());
+        return null;
+    }
+    return component;
+}
+
 /*
  * Main procedures
  */
@@ -76,21 +99,52 @@ function surfaceUnmapped(surface) {
 function surfaceDestroyed(surface) {
     console.debug("Surface", surface, "destroyed");
 
-    // Remove surface from model
-    var i;
-    for (i = 0; i < surfaceModel.count; i++) {
-        var entry = surfaceModel.get(i);
-
-        if (entry.surface === surface) {
-            // Destroy window representation and
-            // remove the surface from the model
-            if (entry.window.chrome)
-                entry.window.chrome.destroy();
-            entry.window.destroy();
-            surfaceModel.remove(i, 1);
-            break;
-        }
-    }
+    // Window representation will be destroyed as soon as incubation is over
+    if (dropPendingSurface(surface))
+        return;
+
+    // Remove surface from model and destroy window representation
+    var window = compositor.surfaceModel.takeWindow(surface, _greenisland_output);
+    if (window)
+        destroyWindow(window);
+}
+
+function surfaceAssigned(surface, index) {
+    console.debug("Surface", surface, "assigned to workspace", index);
+
+    // Windows are children of their workspace
+    var window = compositor.surfaceModel.window(surface, _greenisland_output);
+    if (window)
+        window.parent = workspaceOf(surface);
+}
+
+function dropPendingSurface(surface) {
+    var pendingIndex = pendingSurfaces.indexOf(surface);
+    if (pendingIndex < 0)
+        return false;
+    pendingSurfaces.splice(pendingIndex, 1);
+    pendingIncubators.splice(pendingIndex, 1);
+    return true;
+}
+
+function destroyWindow(window) {
+    // Pooled chromes go back to their effect when the window is gone
+    if (window.chrome && !window.chrome.pooled)
+        window.chrome.destroy();
+    window.destroy();
+}
+
+/*
+ * Workspaces
+ */
+
+function workspaceOf(surface) {
+    // Fall back to the current workspace when the surface was not
+    // assigned yet or its workspace has no item on this output
+    var view = compositorRoot.screenView.workspacesView;
+    var index = compositor.workspaceManager.workspaceOf(surface);
+    var workspace = index >= 0 ? view.workspaceAt(index) : null;
+    return workspace ? workspace : view.currentWorkspace;
 }
 
 /*
@@ -102,30 +156,64 @@ function mapApplicationSurface(surface) {
     // workspace is selected, for all the surfaces in the previous workspace
     // an unmapped signal is emitted; so we need to figure out if a
     // representation for the surface was already created and exit in that case
-    var i;
-    for (i = 0; i < surfaceModel.count; i++) {
-        var entry = surfaceModel.get(i);
+    if (compositor.surfaceModel.window(surface, _greenisland_output))
+        return;
+    if (pendingSurfaces.indexOf(surface) >= 0)
+        return;
 
-        if (entry.surface === surface)
-            return;
-    }
+    // Load the component only the first time
+    clientWindowComponent = loadComponent(clientWindowComponent, "WaylandClientWindow.qml");
+    if (!clientWindowComponent)
+        return;
 
-    // Create surface item
-    var component = Qt.createComponent("WaylandClientWindow.qml");
-    if (component.status !== Component.Ready) {
-        console.error(component.errorString());
+    // Request a view for this output (Items cannot be shared between
+    // windows so a new one is created on demand)
+    var child = compositor.viewForOutput(surface, _greenisland_output);
+
+    // Create the window container asynchronously, this way a burst
+    // of surfaces being mapped is spread over multiple frames
+    var incubator = clientWindowComponent.incubateObject(compositorRoot, {"child": child}, Qt.Asynchronous);
+    if (incubator.status === Component.Ready) {
+        setupApplicationWindow(surface, incubator.object);
         return;
     }
+    pendingSurfaces.push(surface);
+    pendingIncubators.push(incubator);
+    incubator.onStatusChanged = function(status) {
+        if (status === Component.Loading)
+            return;
 
+        // Surface was destroyed or unmapped in the meantime, the view
+        // goes away with the window otherwise it would be reused with
+        // stale state the next time the surface is mapped; a surface
+        // mapped again already shares the view with its new window
+        var pendingIndex = pendingIncubators.indexOf(incubator);
+        if (pendingIndex < 0) {
+            if (child && pendingSurfaces.indexOf(surface) < 0 &&
+                    !compositor.surfaceModel.window(surface, _greenisland_output))
+                child.destroy();
+            if (incubator.object)
+                incubator.object.destroy();
+            return;
+        }
+        pendingSurfaces.splice(pendingIndex, 1);
+        pendingIncubators.splice(pendingIndex, 1);
+
+        if (status === Component.Ready) {
+            setupApplicationWindow(surface, incubator.object);
+        } else {
+            console.error("Failed to create a window for", surface);
+            if (child)
+                child.destroy();
+        }
+    }
+}
+
+function setupApplicationWindow(surface, window) {
     // Window position
     var pos = Qt.point(0, 0);
 
-    // Request a view for this output (Items cannot be shared between
-    // windows so a new one is created on demand)
-    var child = compositor.viewForOutput(surface, _greenisland_output);
-
-    // Create and setup window container
-    var window = component.createObject(compositorRoot, {"child": child});
+    // Setup window container
     window.child.parent = window;
     window.child.touchEventsEnabled = true;
     window.width = surface.size.width;
@@ -182,7 +270,7 @@ function mapApplicationSurface(surface) {
 
     // Reparent and give focus
     if (surface.windowType === WaylandQuickSurface.Toplevel)
-        window.parent = compositorRoot.screenView.currentWorkspace;
+        window.parent = workspaceOf(surface);
     else
         window.parent = transientParentView;
     window.child.takeFocus();
@@ -200,7 +288,7 @@ function mapApplicationSurface(surface) {
         window.runMapAnimation();
 
     // Add surface to the model
-    surfaceModel.append({"surface": surface, "window": window});
+    compositor.surfaceModel.setWindow(surface, _greenisland_output, window);
 }
 
 function mapShellSurface(surface, child) {
@@ -210,15 +298,13 @@ function mapShellSurface(surface, child) {
     if (child.output !== _greenisland_output)
         return;
 
-    // Create surface item
-    var component = Qt.createComponent("WaylandShellWindow.qml");
-    if (component.status !== Component.Ready) {
-        console.error(component.errorString());
+    // Load the component only the first time
+    shellWindowComponent = loadComponent(shellWindowComponent, "WaylandShellWindow.qml");
+    if (!shellWindowComponent)
         return;
-    }
 
     // Create and setup window container
-    var window = component.createObject(compositorRoot, {"child": child});
+    var window = shellWindowComponent.createObject(compositorRoot, {"child": child});
     window.child.parent = window;
     window.child.touchEventsEnabled = true;
     window.width = surface.size.width;
@@ -259,7 +345,7 @@ function mapShellSurface(surface, child) {
     console.debug("\tscreen:", compositorRoot.screenView.name);
 
     // Add surface to the model
-    surfaceModel.append({"surface": surface, "window": window});
+    compositor.surfaceModel.setWindow(surface, _greenisland_output, window);
 }
 
 /*
@@ -267,16 +353,13 @@ function mapShellSurface(surface, child) {
  */
 
 function unmapApplicationSurface(surface) {
-    // Find window representation
-    var i, window = null;
-    for (i = 0; i < surfaceModel.count; i++) {
-        var entry = surfaceModel.get(i);
+    // Surfaces unmapped before their window was created don't need
+    // one anymore, it's discarded as soon as incubation is over
+    if (dropPendingSurface(surface))
+        return;
 
-        if (entry.surface === surface) {
-            window = entry.window;
-            break;
-        }
-    }
+    // Find window representation
+    var window = compositor.surfaceModel.window(surface, _greenisland_output);
     if (!window)
         return;
 
@@ -291,10 +374,8 @@ function unmapApplicationSurface(surface) {
     // in the surface model and don't create a window representation, hence
     // we destroy the surface item when it's unmapped
     if (surface.windowType === WaylandQuickSurface.Popup) {
-        if (window.chrome)
-            window.chrome.destroy();
-        window.destroy();
-        surfaceModel.remove(i, 1);
+        compositor.surfaceModel.takeWindow(surface, _greenisland_output);
+        destroyWindow(window);
     }
 }
 
@@ -29,8 +29,17 @@ import QtQuick 2.0
 Item {
     property alias effects: effects
 
+    // Windows report damage while thumbnails of this workspace
+    // are shown, so that the cached copy is refreshed
+    property bool trackDamage: false
+    property bool damaged: false
+
     id: root
 
+    function markDamaged() {
+        damaged = true;
+    }
+
     Effects {
         id: effects
         workspace: root
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * This file is part of Hawaii Shell.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+import QtQuick 2.0
+
+/*
+ * Reduced resolution copy of a workspace.
+ *
+ * The current workspace is copied whenever it changes, the others
+ * only when their windows are damaged and no more than maximumRate
+ * times per second. Nothing is copied while the thumbnail is hidden
+ * but the texture is kept.
+ */
+
+ShaderEffectSource {
+    property Item workspace
+    property bool current: false
+    property int maximumRate: 4
+    property real resolution: 0.25
+
+    id: thumbnail
+    sourceItem: workspace
+    textureSize: workspace ? Qt.size(Math.ceil(workspace.width * resolution),
+                                     Math.ceil(workspace.height * resolution))
+                           : Qt.size(1, 1)
+    live: current && visible
+    smooth: true
+
+    // Windows keep rendering only while their copy is shown
+    Binding {
+        target: thumbnail.workspace
+        property: "trackDamage"
+        value: thumbnail.visible
+        when: thumbnail.workspace !== null
+    }
+
+    Timer {
+        interval: 1000 / thumbnail.maximumRate
+        repeat: true
+        running: thumbnail.visible && !thumbnail.live
+        onTriggered: {
+            if (thumbnail.workspace && thumbnail.workspace.damaged) {
+                thumbnail.workspace.damaged = false;
+                thumbnail.scheduleUpdate();
+            }
+        }
+    }
+}
@@ -29,32 +29,21 @@ import QtQuick 2.0
 WorkspacesView {
     id: root
     view: listView
-    onWorkspaceAdded: {
-        workspaces.model++;
-    }
-    onWorkspaceRemoved: {
-        // Reparent all windows to the previous or next workspace
-        var prevIndex = index == 0 ? 1 : index - 1;
-        var workspace = workspaces.itemAt(index);
-        var prevWorkspace = workspaces.itemAt(prevIndex);
-        var i;
-        for (i = 0; i < workspace.children.length; i++) {
-            var window = workspace.children[i];
-            window.parent = prevWorkspace;
-        }
 
-        // Remove item
-        listView.currentIndex = prevIndex;
-        workspaces.model--;
-    }
-    onWorkspaceSelected: {
-        listView.currentIndex = index;
+    function workspaceAt(index) {
+        return workspaces.itemAt(index);
     }
 
     Flickable {
-        property int currentIndex: -1
-        property Workspace currentItem: workspaces.itemAt(currentIndex)
-        property int count: workspaces.model
+        property int currentIndex: root.currentIndex
+        property Workspace currentItem: workspaces.count > currentIndex ? workspaces.itemAt(currentIndex) : null
+        property int count: workspaces.count
+
+        // Content is still on its way to the current workspace, this is
+        // already true when the index changes and before the animation
+        // starts so the previous workspace doesn't leave in between
+        readonly property bool switching: switchAnimation.running ||
+                                          contentX != currentIndex * root.width
 
         id: listView
         anchors.fill: parent
@@ -67,24 +56,38 @@ WorkspacesView {
 
         Behavior on contentX {
             NumberAnimation {
+                id: switchAnimation
                 easing.type: Easing.InOutQuad
                 duration: 250
             }
         }
 
         Item {
-            width: root.width * workspaces.model
+            id: container
+            width: root.width * workspaces.count
             height: root.height
 
             Repeater {
                 id: workspaces
-                model: 0
+                model: compositor.workspaceManager
 
                 Workspace {
+                    // Workspaces that are not shown are taken out of the
+                    // scene so they don't contribute any node, their windows
+                    // are also hidden so that clients stop rendering; only
+                    // the workspace being left stays while switching
+                    readonly property bool shown: index == listView.currentIndex ||
+                                                  (listView.switching && index == root.previousIndex) ||
+                                                  root.showAll
+
+                    id: workspace
                     x: index * width
                     y: 0
                     width: listView.width
                     height: listView.height
+                    visible: shown
+                    onShownChanged: workspace.parent = shown ? container : null
+                    Component.onCompleted: workspace.parent = shown ? container : null
                 }
             }
         }
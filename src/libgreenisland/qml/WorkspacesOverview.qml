@@ -0,0 +1,92 @@
+/****************************************************************************
+ * This file is part of Hawaii Shell.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+import QtQuick 2.0
+
+/*
+ * Shows all workspaces at once, from cached copies.
+ *
+ * Workspaces are hidden from their usual place while the overview
+ * is shown, so that each window is drawn only into the copy of its
+ * workspace.
+ */
+
+Rectangle {
+    property var workspacesView
+    readonly property int count: workspacesView && workspacesView.view ? workspacesView.view.count : 0
+    readonly property int columns: Math.max(1, Math.ceil(Math.sqrt(count)))
+    readonly property int rows: Math.max(1, Math.ceil(count / columns))
+    property real spacing: 20
+
+    id: overview
+    color: "black"
+    visible: false
+
+    function show() {
+        visible = true;
+    }
+
+    function hide() {
+        visible = false;
+    }
+
+    function toggle() {
+        visible = !visible;
+    }
+
+    Grid {
+        readonly property real cellWidth: (overview.width - overview.spacing * (overview.columns + 1)) / overview.columns
+        readonly property real cellHeight: (overview.height - overview.spacing * (overview.rows + 1)) / overview.rows
+        readonly property real scale: Math.min(cellWidth / overview.width, cellHeight / overview.height)
+
+        id: grid
+        anchors.centerIn: parent
+        columns: overview.columns
+        spacing: overview.spacing
+
+        Repeater {
+            // Thumbnails are kept while the overview is hidden so
+            // that their textures are reused the next time it's shown
+            model: overview.count
+
+            WorkspaceThumbnail {
+                width: overview.width * grid.scale
+                height: overview.height * grid.scale
+                workspace: overview.workspacesView.workspaceAt(index)
+                current: index === overview.workspacesView.currentIndex
+                hideSource: overview.visible
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        overview.workspacesView.select(index);
+                        overview.hide();
+                    }
+                }
+            }
+        }
+    }
+}
@@ -29,46 +29,38 @@ import QtQuick.Controls 1.2
 
 Item {
     readonly property Item currentWorkspace:  view ? view.currentItem : null
-    readonly property int currentIndex: view ? view.currentIndex : -1
+    readonly property int currentIndex: compositor.workspaceManager.currentIndex
+    readonly property int previousIndex: compositor.workspaceManager.previousIndex
     property Item view
 
-    signal workspaceAdded(int index)
-    signal workspaceRemoved(int index);
-    signal workspaceSelected(int index);
+    // Keep all workspaces in the scene, for example while
+    // the overview draws their copies
+    property bool showAll: false
 
     id: root
 
     function add() {
-        root.workspaceAdded(view.count);
+        compositor.workspaceManager.add();
     }
 
     function remove(index) {
-        root.workspaceRemoved(index);
+        compositor.workspaceManager.remove(index);
     }
 
     function select(index) {
-        root.workspaceSelected(index);
+        compositor.workspaceManager.select(index);
     }
 
-    function selectPrevious() {
-        // Previous index (avoid overflow)
-        var prevIndex = view.currentIndex - 1;
-        if (prevIndex < 0)
-            prevIndex = view.count - 1;
-        if (prevIndex < 0)
-            prevIndex = 0;
+    // Views that know how to find a workspace override this
+    function workspaceAt(index) {
+        return null;
+    }
 
-        // Select workspace
-        select(prevIndex);
+    function selectPrevious() {
+        compositor.workspaceManager.selectPrevious();
     }
 
     function selectNext() {
-        // Next index (avoid overflow)
-        var nextIndex = view.currentIndex + 1;
-        if (nextIndex >= view.count)
-            nextIndex = 0;
-
-        // Select workspace
-        select(nextIndex);
+        compositor.workspaceManager.selectNext();
     }
 }
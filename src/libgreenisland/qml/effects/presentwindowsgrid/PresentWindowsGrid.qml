@@ -26,12 +26,67 @@
 
 import QtQuick 2.0
 import QtCompositor 1.0
+import GreenIsland 1.0
 
 Item {
     property Item workspace: null
 
+    // Chromes are reused across activations
+    property var chromePool: []
+    property var chromes: []
+
     id: root
 
+    WindowLayout {
+        id: layout
+        mode: WindowLayout.Grid
+        spacing: 0
+    }
+
+    Component {
+        id: chromeComponent
+
+        WindowChrome {
+            id: chrome
+            pooled: true
+            onWindowChanged: {
+                // The window went away while presented
+                if (!window)
+                    root.recycleChrome(chrome);
+            }
+            onClicked: {
+                // Chrome goes back to the pool when the effect ends
+                var clientWindow = window.parent;
+                root.end();
+                clientWindow.z = 1;
+            }
+        }
+    }
+
+    function takeChrome(parent) {
+        // Chromes are owned by the effect, windows only show them
+        var chrome = chromePool.length > 0 ? chromePool.pop() : chromeComponent.createObject(root);
+        chrome.parent = parent;
+        chrome.visible = true;
+        chromes.push(chrome);
+        return chrome;
+    }
+
+    function recycleChrome(chrome) {
+        var index = chromes.indexOf(chrome);
+        if (index >= 0)
+            chromes.splice(index, 1);
+        chrome.visible = false;
+        chrome.parent = root;
+        if (chromePool.indexOf(chrome) < 0)
+            chromePool.push(chrome);
+    }
+
+    function releaseChromes() {
+        while (chromes.length > 0)
+            recycleChrome(chromes[chromes.length - 1]);
+    }
+
     function run() {
         // Sanity check
         if (!workspace) {
@@ -47,16 +102,8 @@ Item {
         // Disable output zoom
         compositorRoot.screenView.zoomEnabled = false;
 
-        // Calculate rows and columns
-        var columns = Math.ceil(Math.sqrt(num));
-        var rows = Math.ceil(num / columns);
-
-        // Calculate cell size
-        var cellWidth = compositorRoot.width / columns;
-        var cellHeight = compositorRoot.height / rows;
-
-        // Loop over windows
-        var i, index = 0, ix = 0, iy = 0, lastDim = 1, window;
+        // Find windows to present
+        var i, window, windows = [], geometries = [];
         for (i = 0; i < num; i++) {
             // Find window
             window = workspace.children[i];
@@ -73,6 +120,17 @@ Item {
             if (window.child.surface.windowType !== WaylandQuickSurface.Toplevel)
                 continue;
 
+            windows.push(window);
+            geometries.push(Qt.rect(window.x, window.y, window.width, window.height));
+        }
+
+        // Calculate the layout, rectangles are returned in the same order
+        var rects = layout.arrange(geometries, Qt.rect(0, 0, compositorRoot.width, compositorRoot.height));
+
+        for (i = 0; i < windows.length; i++) {
+            window = windows[i];
+            var rect = rects[i];
+
             // Save original properties
             window.savedProperties.x = window.x;
             window.savedProperties.y = window.y;
@@ -82,47 +140,20 @@ Item {
             if (window.savedProperties.chrome)
                 window.savedProperties.chrome.visible = false;
 
-            // Calculate grid
-            if (index > 0) {
-                var currentDim = Math.ceil(Math.sqrt(i + 1));
-                if (currentDim == lastDim) {
-                    if (iy < currentDim - 1) {
-                        ++iy;
-
-                        if (iy == currentDim - 1)
-                            ix = 0;
-                    } else {
-                        ++ix;
-                    }
-                } else {
-                    iy = 0;
-                    ix = currentDim - 1;
-                }
-                lastDim = currentDim;
-            }
-
-            var cx = (ix + 0.5) * cellWidth;
-            var cy = (iy + 0.5) * cellHeight;
-
-            // Create a chrome
-            var chromeComponent = Qt.createComponent("WindowChrome.qml");
-            var chrome = chromeComponent.createObject(window.child);
-            window.chrome = chrome;
-            window.chrome.clicked.connect(function() {
-                root.end();
-                window.z = 1;
-            });
+            // Add a chrome
+            window.chrome = takeChrome(window.child);
 
             // Enable behavior animations
             window.animationsEnabled = true;
 
-            // Apply new properties
-            window.x = cx - window.width / 2;
-            window.y = cy - window.height / 2;
-            window.z = 1;
-            window.scale = 0.98 * Math.min(cellWidth / window.width, cellHeight / window.height);
+            // Shrunk windows are drawn from mipmapped copies
+            window.thumbnailMode = true;
 
-            index++;
+            // Apply new properties, windows are scaled around their center
+            window.x = rect.x + (rect.width - window.width) / 2;
+            window.y = rect.y + (rect.height - window.height) / 2;
+            window.z = 1;
+            window.scale = 0.98 * rect.width / window.width;
         }
     }
 
@@ -133,6 +164,9 @@ Item {
             return;
         }
 
+        // Chromes go back to the pool
+        releaseChromes();
+
         // If there are no windows don't spare CPU time and exit
         var num = workspace.children.length;
         if (num === 0)
@@ -146,12 +180,6 @@ Item {
             if (window.objectName !== "clientWindow")
                 continue;
 
-            // Remove chrome
-            if (window.chrome) {
-                window.chrome.destroy();
-                window.chrome = null;
-            }
-
             // Restore saved properties
             window.x = window.savedProperties.x;
             window.y = window.savedProperties.y;
@@ -160,6 +188,7 @@ Item {
             window.chrome = window.savedProperties.chrome;
             if (window.chrome)
                 window.chrome.visible = true;
+            window.thumbnailMode = false;
 
             // Enable behavior animations
             window.animationsEnabled = true;
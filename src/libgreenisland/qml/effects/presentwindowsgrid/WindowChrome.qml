@@ -29,6 +29,9 @@ import QtQuick 2.0
 Item {
     property var window: parent
 
+    // Pooled chromes belong to the effect that shows them
+    property bool pooled: false
+
     signal clicked()
 
     id: root
@@ -0,0 +1,124 @@
+/****************************************************************************
+ * This file is part of Hawaii Shell.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+import QtQuick 2.0
+
+/*
+ * Magnifies the screen contents.
+ *
+ * The source is rendered once to a texture at its own size and
+ * the zoomed area is sampled with a single shader pass, instead of
+ * rasterizing every window again at the magnified size.
+ *
+ * The focus point is shown where it actually is, with pointer
+ * tracking this means that what's under the pointer on screen is
+ * also what receives input. With keyboard tracking the output
+ * window maps pointer and touch input through the zoom instead.
+ */
+
+Item {
+    property Item sourceItem
+    property real zoom: 1.0
+
+    // Magnify only a circle around the focus point
+    property bool lens: false
+    property real lensRadius: 150
+
+    // Either "pointer" or "keyboard"
+    property string tracking: "pointer"
+
+    readonly property bool active: zoom > 1.0
+    readonly property point focusPoint: {
+        if (tracking == "keyboard") {
+            var item = _greenisland_window.activeFocusItem;
+            if (item && sourceItem)
+                return item.mapToItem(sourceItem, item.width / 2, item.height / 2);
+        }
+        return _greenisland_window.pointerPosition;
+    }
+    readonly property point clampedFocusPoint: Qt.point(Math.max(0, Math.min(focusPoint.x, width)),
+                                                        Math.max(0, Math.min(focusPoint.y, height)))
+
+    id: magnifier
+    onActiveChanged: updateInputMagnification()
+    onZoomChanged: updateInputMagnification()
+    onLensChanged: updateInputMagnification()
+    onLensRadiusChanged: updateInputMagnification()
+    onTrackingChanged: updateInputMagnification()
+    onClampedFocusPointChanged: updateInputMagnification()
+
+    function updateInputMagnification() {
+        // What's under the pointer is already what receives input
+        // when the pointer is tracked
+        var factor = active && tracking == "keyboard" ? zoom : 1.0;
+        _greenisland_window.setInputMagnification(factor, clampedFocusPoint,
+                                                  lens ? lensRadius : 0);
+    }
+
+    ShaderEffectSource {
+        id: capture
+        sourceItem: magnifier.active ? magnifier.sourceItem : null
+        hideSource: magnifier.active
+        smooth: true
+        visible: false
+    }
+
+    ShaderEffect {
+        anchors.fill: parent
+        visible: magnifier.active
+
+        property variant source: capture
+        property real zoom: magnifier.zoom
+        property real lens: magnifier.lens ? 1.0 : 0.0
+        property point focusPoint: width > 0 && height > 0
+                                   ? Qt.point(magnifier.clampedFocusPoint.x / width,
+                                              magnifier.clampedFocusPoint.y / height)
+                                   : Qt.point(0, 0)
+        property size radius: width > 0 && height > 0
+                              ? Qt.size(magnifier.lensRadius / width, magnifier.lensRadius / height)
+                              : Qt.size(1, 1)
+
+        fragmentShader: "
+            uniform sampler2D source;
+            uniform lowp float qt_Opacity;
+            uniform highp float zoom;
+            uniform highp float lens;
+            uniform highp vec2 focusPoint;
+            uniform highp vec2 radius;
+            varying highp vec2 qt_TexCoord0;
+
+            void main() {
+                highp vec2 uv = focusPoint + (qt_TexCoord0 - focusPoint) / zoom;
+
+                // Outside the lens the screen is shown as is
+                highp vec2 d = (qt_TexCoord0 - focusPoint) / radius;
+                if (lens > 0.5 && dot(d, d) > 1.0)
+                    uv = qt_TexCoord0;
+
+                gl_FragColor = texture2D(source, uv) * qt_Opacity;
+            }"
+    }
+}
@@ -34,8 +34,12 @@ Item {
     property alias showInformation: outputInfo.visible
 
     readonly property alias workspacesView: workspacesLayer
+    readonly property alias workspacesOverview: workspacesOverview
     readonly property alias currentWorkspace: workspacesLayer.currentWorkspace
     property alias zoomEnabled: zoomArea.enabled
+    property alias zoomLens: magnifier.lens
+    property alias zoomTracking: magnifier.tracking
+    readonly property alias blurCache: blurCache
 
     property var layers: QtObject {
         readonly property alias background: backgroundLayer
@@ -51,13 +55,6 @@ Item {
     }
 
     id: root
-    transform: Scale {
-        id: screenScaler
-        origin.x: zoomArea.x2
-        origin.y: zoomArea.y2
-        xScale: zoomArea.zoom2
-        yScale: zoomArea.zoom2
-    }
 
     /*
      * Output information panel
@@ -82,126 +79,173 @@ Item {
     ScreenZoom {
         id: zoomArea
         anchors.fill: parent
-        scaler: screenScaler
+        magnifier: magnifier
         enabled: true
         z: 3000
     }
 
-    /*
-     * Special layers
-     */
-
-    // Splash is above everything but the cursor layer
-    Rectangle {
-        id: splashLayer
+    Magnifier {
+        id: magnifier
         anchors.fill: parent
-        color: "black"
-        z: 2000
-        opacity: 0.0
-
-        Behavior on opacity {
-            NumberAnimation {
-                easing.type: Easing.InOutQuad
-                duration: 250
-            }
-        }
+        sourceItem: screenContent
+        z: 2500
     }
 
-    // Modal overlay for dialogs
-    Rectangle {
-        id: modalOverlay
+    // Everything the magnifier shows
+    Item {
+        id: screenContent
         anchors.fill: parent
-        color: "black"
-        opacity: 0.0
 
-        // Globally modal dialogs can cover applications and shell gadgets
-        Item {
-            id: dialogsLayer
+        /*
+         * Special layers
+         */
+
+        // Splash is above everything but the cursor layer
+        Rectangle {
+            id: splashLayer
             anchors.fill: parent
-        }
+            color: "black"
+            z: 2000
+            opacity: 0.0
 
-        Behavior on opacity {
-            NumberAnimation {
-                easing.type: Easing.InOutQuad
-                duration: 250
+            Behavior on opacity {
+                NumberAnimation {
+                    easing.type: Easing.InOutQuad
+                    duration: 250
+                }
             }
         }
-    }
 
-    // Lock screen is above all windows to shield the session
-    Item {
-        id: lockLayer
-        anchors.fill: parent
-    }
+        // Modal overlay for dialogs
+        Rectangle {
+            id: modalOverlay
+            anchors.fill: parent
+            color: "black"
+            opacity: 0.0
 
-    /*
-     * Workspace
-     */
+            // Globally modal dialogs can cover applications and shell gadgets
+            Item {
+                id: dialogsLayer
+                anchors.fill: parent
+            }
 
-    Item {
-        id: userLayer
-        anchors.fill: parent
+            Behavior on opacity {
+                NumberAnimation {
+                    easing.type: Easing.InOutQuad
+                    duration: 250
+                }
+            }
+        }
 
-        // Application and shell windows
+        // Lock screen is above all windows to shield the session
         Item {
-            id: sessionLayer
+            id: lockLayer
             anchors.fill: parent
+        }
 
-            // Background is below everything
-            Image {
-                id: backgroundLayer
-                anchors.fill: parent
-                source: "../../images/wallpaper.png"
-                fillMode: Image.Tile
-            }
+        /*
+         * Workspace
+         */
+
+        Item {
+            id: userLayer
+            anchors.fill: parent
 
-            // Desktop is only above to the background
+            // Application and shell windows
             Item {
-                id: desktopLayer
+                id: sessionLayer
                 anchors.fill: parent
-            }
+                // Workspaces are drawn only into their copies while the
+                // overview covers everything; opacity rather than visible
+                // so that windows stay visible and clients keep drawing
+                opacity: workspacesOverview.visible ? 0.0 : 1.0
+                enabled: !workspacesOverview.visible
 
-            // Workspaces
-            WorkspacesLinearView {
-                id: workspacesLayer
-                anchors.fill: parent
+                // Everything shell windows can blur
+                Item {
+                    id: contentLayer
+                    anchors.fill: parent
+
+                    // Background is below everything
+                    Image {
+                        id: backgroundLayer
+                        anchors.fill: parent
+                        source: "../../images/wallpaper.png"
+                        fillMode: Image.Tile
+                        onStatusChanged: blurCache.invalidate()
+                    }
+
+                    // Desktop is only above to the background
+                    Item {
+                        id: desktopLayer
+                        anchors.fill: parent
+                    }
+
+                    // Workspaces
+                    WorkspacesLinearView {
+                        id: workspacesLayer
+                        anchors.fill: parent
+                        showAll: workspacesOverview.visible
+                    }
+                }
+
+                // Blurred copy of the content for shell windows
+                BlurBehindCache {
+                    id: blurCache
+                    anchors.fill: parent
+                    sourceItem: contentLayer
+                }
+
+                // Switching workspace moves windows without damage
+                Connections {
+                    target: workspacesLayer.view
+                    onContentXChanged: blurCache.invalidate()
+                }
+
+                // Panels are above application windows
+                Item {
+                    id: panelsLayer
+                    anchors.fill: parent
+                }
+
+                // Notifications are above panels
+                Item {
+                    id: notificationsLayer
+                    anchors.fill: parent
+                }
+
+                // Overlays can cover pretty much everything except the lock screen
+                Item {
+                    id: overlayLayer
+                    anchors.fill: parent
+                }
             }
 
-            // Panels are above application windows
+            // Full screen windows can cover application windows and panels
             Item {
-                id: panelsLayer
+                id: fullScreenLayer
                 anchors.fill: parent
+                visible: false
             }
 
-            // Notifications are above panels
-            Item {
-                id: notificationsLayer
+            // Overview of all workspaces, covers windows and panels
+            WorkspacesOverview {
+                id: workspacesOverview
                 anchors.fill: parent
+                workspacesView: workspacesLayer
             }
 
-            // Overlays can cover pretty much everything except the lock screen
-            Item {
-                id: overlayLayer
+            // Hot corners
+            HotCorners {
+                id: hotCorners
                 anchors.fill: parent
+                rotation: 0
+                onTopLeftTriggered: workspacesLayer.selectPrevious()
+                onTopRightTriggered: workspacesLayer.selectNext()
+                onBottomLeftTriggered: compositorRoot.toggleEffect("PresentWindowsGrid")
+                onBottomRightTriggered: workspacesOverview.toggle()
             }
         }
-
-        // Full screen windows can cover application windows and panels
-        Item {
-            id: fullScreenLayer
-            anchors.fill: parent
-            visible: false
-        }
-
-        // Hot corners
-        HotCorners {
-            id: hotCorners
-            anchors.fill: parent
-            rotation: 0
-            onTopLeftTriggered: workspacesLayer.selectPrevious()
-            onTopRightTriggered: workspacesLayer.selectNext()
-            onBottomLeftTriggered: compositorRoot.toggleEffect("PresentWindowsGrid")
-        }
     }
 
     /**
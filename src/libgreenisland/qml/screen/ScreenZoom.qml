@@ -27,49 +27,28 @@
 import QtQuick 2.0
 
 MouseArea {
-    property var scaler
+    property var magnifier
 
-    property real x1: 0.0
-    property real y1: 0.0
-    property real x2: 0.0
-    property real y2: 0.0
-    property real zoom1: 1.0
-    property real zoom2: 1.0
     property real min: 1.0
     property real max: 10.0
 
     id: zoomArea
     acceptedButtons: Qt.NoButton
     propagateComposedEvents: true
-    drag.target: parent
-    drag.filterChildren: true
     onWheel: {
         if (!(wheel.modifiers & Qt.MetaModifier)) {
             wheel.accepted = false;
             return;
         }
 
-        zoomArea.x1 = scaler.origin.x;
-        zoomArea.y1 = scaler.origin.y;
-        zoomArea.zoom1 = scaler.xScale;
-        zoomArea.x2 = wheel.x;
-        zoomArea.y2 = wheel.y;
-
-        var newZoom;
-        if (wheel.angleDelta.y > 0) {
-            newZoom = zoomArea.zoom1 + 0.1;
-            if (newZoom <= zoomArea.max)
-                zoomArea.zoom2 = newZoom;
-            else
-                zoomArea.zoom2 = zoomArea.max;
-        } else {
-            newZoom = zoomArea.zoom1 - 0.1;
-            if (newZoom >= zoomArea.min)
-                zoomArea.zoom2 = newZoom;
-            else
-                zoomArea.zoom2 = zoomArea.min;
-        }
+        var newZoom = magnifier.zoom + (wheel.angleDelta.y > 0 ? 0.1 : -0.1);
+        magnifier.zoom = Math.max(zoomArea.min, Math.min(newZoom, zoomArea.max));
 
         wheel.accepted = true;
     }
+    onEnabledChanged: {
+        // Go back to normal size when zoom is disabled
+        if (!enabled)
+            magnifier.zoom = 1.0;
+    }
 }
@@ -24,9 +24,16 @@
  * $END_LICENSE$
  ***************************************************************************/
 
+#include <QtQuick/QQuickWindow>
 #include <QtCompositor/QWaylandClient>
+#include <QtCompositor/QWaylandSurfaceItem>
+#include <QtCompositor/private/qwloutput_p.h>
+#include <QtCompositor/private/qwlsurface_p.h>
 
 #include "compositor.h"
+#include "output.h"
+#include "outputlayout.h"
+#include "outputwindow.h"
 #include "quicksurface.h"
 
 namespace GreenIsland {
@@ -35,7 +42,33 @@ QuickSurface::QuickSurface(QWaylandClient *client, quint32 id, int version, Comp
     : QWaylandQuickSurface(client->client(), id, version, compositor)
     , m_state(Normal)
     , m_globalPos(0, 0)
+    , m_hasPendingGlobalPos(false)
+    , m_contrast(1.0)
+    , m_intensity(1.0)
+    , m_saturation(1.0)
+    , m_shellRole(false)
+    , m_textureEvicted(false)
 {
+    // Outputs are entered or left when the geometry changes
+    // and when the surface is mapped or unmapped
+    connect(this, SIGNAL(globalGeometryChanged()),
+            this, SLOT(updateOutputs()));
+    connect(this, SIGNAL(sizeChanged()),
+            this, SLOT(updateOutputs()));
+    connect(this, SIGNAL(mapped()),
+            this, SLOT(updateOutputs()));
+    connect(this, SIGNAL(unmapped()),
+            this, SLOT(updateOutputs()));
+
+    // Unmapped surfaces are not rendered, a pending position
+    // would otherwise wait for a frame that never comes
+    connect(this, SIGNAL(unmapped()),
+            this, SLOT(applyPendingGlobalPosition()));
+
+    // Clients may bind wl_output after the surface entered it,
+    // there's no way to know when so check at every commit
+    connect(this, SIGNAL(configure(bool)),
+            this, SLOT(enterBoundOutputs()));
 }
 
 QuickSurface::State QuickSurface::state() const
@@ -59,6 +92,9 @@ QPointF QuickSurface::globalPosition() const
 
 void QuickSurface::setGlobalPosition(const QPointF &pos)
 {
+    // Explicit positions win over the ones that are not applied yet
+    m_hasPendingGlobalPos = false;
+
     if (m_globalPos == pos)
         return;
 
@@ -67,11 +103,250 @@ void QuickSurface::setGlobalPosition(const QPointF &pos)
     Q_EMIT globalGeometryChanged();
 }
 
+void QuickSurface::requestGlobalPosition(const QPointF &pos)
+{
+    m_pendingGlobalPos = pos;
+    if (m_hasPendingGlobalPos)
+        return;
+
+    // Apply the position when the first window showing this
+    // surface is about to render its next frame, or as soon as
+    // it stops rendering or goes away before that happens
+    bool scheduled = false;
+    for (QWaylandSurfaceView *surfaceView: views()) {
+        QWaylandSurfaceItem *view = static_cast<QWaylandSurfaceItem *>(surfaceView);
+        QQuickWindow *window = view->window();
+        if (!window || !window->isVisible() || !view->isVisible())
+            continue;
+
+        OutputWindow *outputWindow = qobject_cast<OutputWindow *>(window);
+        if (outputWindow && !outputWindow->isRenderingEnabled())
+            continue;
+
+        if (!m_frameWindows.contains(window)) {
+            connect(window, SIGNAL(afterAnimating()),
+                    this, SLOT(applyPendingGlobalPosition()));
+            connect(window, SIGNAL(visibleChanged(bool)),
+                    this, SLOT(applyPendingGlobalPosition()));
+            connect(window, SIGNAL(destroyed()),
+                    this, SLOT(applyPendingGlobalPosition()));
+            m_frameWindows.append(window);
+        }
+        window->update();
+        scheduled = true;
+    }
+
+    // Nothing is going to be rendered, move right away
+    if (!scheduled) {
+        setGlobalPosition(pos);
+        return;
+    }
+
+    m_hasPendingGlobalPos = true;
+}
+
 QRectF QuickSurface::globalGeometry() const
 {
     return QRectF(m_globalPos, QSizeF(size()));
 }
 
+void QuickSurface::slide(Output *output, const QPointF &from, const QPointF &to)
+{
+    // Input and outputs follow the final position while the
+    // animation runs on the render thread; each view maps the
+    // global points to the output it belongs to
+    QPointF globalTo = output->mapToGlobal(to);
+    setGlobalPosition(globalTo);
+    Q_EMIT slideRequested(output->mapToGlobal(from), globalTo);
+}
+
+bool QuickSurface::hasBlurBehind() const
+{
+    return !m_blurRegion.isEmpty();
+}
+
+QRegion QuickSurface::blurRegion() const
+{
+    return m_blurRegion;
+}
+
+void QuickSurface::setBlurRegion(const QRegion &region)
+{
+    if (m_blurRegion == region)
+        return;
+
+    m_blurRegion = region;
+    Q_EMIT blurRegionChanged();
+}
+
+QVariantList QuickSurface::blurRects() const
+{
+    QVariantList list;
+    for (const QRect &rect: m_blurRegion.rects())
+        list.append(QRectF(rect));
+    return list;
+}
+
+bool QuickSurface::hasContrastBehind() const
+{
+    return !m_contrastRegion.isEmpty();
+}
+
+QRegion QuickSurface::contrastRegion() const
+{
+    return m_contrastRegion;
+}
+
+qreal QuickSurface::contrast() const
+{
+    return m_contrast;
+}
+
+qreal QuickSurface::intensity() const
+{
+    return m_intensity;
+}
+
+qreal QuickSurface::saturation() const
+{
+    return m_saturation;
+}
+
+void QuickSurface::setContrast(const QRegion &region, qreal contrast,
+                               qreal intensity, qreal saturation)
+{
+    if (m_contrastRegion == region && m_contrast == contrast &&
+            m_intensity == intensity && m_saturation == saturation)
+        return;
+
+    m_contrastRegion = region;
+    m_contrast = contrast;
+    m_intensity = intensity;
+    m_saturation = saturation;
+    Q_EMIT contrastChanged();
+}
+
+bool QuickSurface::isTextureEvicted() const
+{
+    return m_textureEvicted;
+}
+
+QImage QuickSurface::snapshot() const
+{
+    return m_snapshot;
+}
+
+bool QuickSurface::hasShellRole() const
+{
+    return m_shellRole;
+}
+
+void QuickSurface::setShellRole(bool value)
+{
+    if (m_shellRole == value)
+        return;
+
+    m_shellRole = value;
+    updateOutputs();
+}
+
+QList<Output *> QuickSurface::enteredOutputs() const
+{
+    return m_outputs.toList();
+}
+
+void QuickSurface::updateOutputs()
+{
+    // Surfaces without a size or a shell role, or that are
+    // not mapped, are nowhere
+    QRectF geometry = globalGeometry();
+
+    QSet<Output *> outputs;
+    if (m_shellRole && isMapped() && geometry.isValid()) {
+        Compositor *compositor = static_cast<Compositor *>(this->compositor());
+        outputs = compositor->outputLayout()->outputsFor(geometry).toSet();
+    }
+
+    // Tell the client only about what changed
+    for (Output *output: m_outputs) {
+        if (!outputs.contains(output))
+            sendLeave(output);
+    }
+    for (Output *output: outputs) {
+        if (!m_outputs.contains(output)) {
+            connect(output, SIGNAL(destroyed(QObject*)),
+                    this, SLOT(outputDestroyed(QObject*)),
+                    Qt::UniqueConnection);
+            sendEnter(output);
+        }
+    }
+
+    m_outputs = outputs;
+}
+
+void QuickSurface::applyPendingGlobalPosition()
+{
+    for (QQuickWindow *window: m_frameWindows) {
+        if (window)
+            disconnect(window, Q_NULLPTR, this, SLOT(applyPendingGlobalPosition()));
+    }
+    m_frameWindows.clear();
+
+    if (m_hasPendingGlobalPos)
+        setGlobalPosition(m_pendingGlobalPos);
+}
+
+void QuickSurface::outputDestroyed(QObject *object)
+{
+    // The wl_output global goes away with it, no need to send leave
+    Output *output = static_cast<Output *>(object);
+    m_outputs.remove(output);
+    m_enteredResources.remove(output);
+}
+
+void QuickSurface::enterBoundOutputs()
+{
+    for (Output *output: m_outputs)
+        sendEnter(output);
+}
+
+void QuickSurface::sendEnter(Output *output)
+{
+    // Only resources bound by the client that owns this surface,
+    // and only once for each of them
+    wl_client *wlClient = client()->client();
+    const QSet<wl_resource *> entered = m_enteredResources.value(output);
+    QSet<wl_resource *> resources;
+    for (QtWayland::Output::Resource *resource: output->handle()->resourceMap().values(wlClient)) {
+        resources.insert(resource->handle);
+        if (!entered.contains(resource->handle))
+            handle()->send_enter(resource->handle);
+    }
+    m_enteredResources.insert(output, resources);
+}
+
+void QuickSurface::sendLeave(Output *output)
+{
+    disconnect(output, SIGNAL(destroyed(QObject*)),
+               this, SLOT(outputDestroyed(QObject*)));
+    m_enteredResources.remove(output);
+
+    wl_client *wlClient = client()->client();
+    for (QtWayland::Output::Resource *resource: output->handle()->resourceMap().values(wlClient))
+        handle()->send_leave(resource->handle);
+}
+
+void QuickSurface::setTextureEvicted(bool evicted, const QImage &snapshot)
+{
+    m_snapshot = snapshot;
+
+    if (m_textureEvicted == evicted)
+        return;
+
+    m_textureEvicted = evicted;
+    Q_EMIT textureEvictedChanged();
+}
+
 }
 
 #include "moc_quicksurface.cpp"
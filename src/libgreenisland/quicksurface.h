@@ -27,15 +27,25 @@
 #ifndef QUICKSURFACE_H
 #define QUICKSURFACE_H
 
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtGui/QImage>
+#include <QtGui/QRegion>
 #include <QtCompositor/QWaylandQuickSurface>
 
 #include <greenisland/greenisland_export.h>
 
+class QQuickWindow;
 class QWaylandClient;
 
+struct wl_resource;
+
 namespace GreenIsland {
 
 class Compositor;
+class Output;
+class TextureBudgetPrivate;
 
 class GREENISLAND_EXPORT QuickSurface : public QWaylandQuickSurface
 {
@@ -43,6 +53,10 @@ class GREENISLAND_EXPORT QuickSurface : public QWaylandQuickSurface
     Q_PROPERTY(State state READ state WRITE setState NOTIFY stateChanged)
     Q_PROPERTY(QPointF globalPosition READ globalPosition WRITE setGlobalPosition NOTIFY globalPositionChanged)
     Q_PROPERTY(QRectF globalGeometry READ globalGeometry NOTIFY globalGeometryChanged)
+    Q_PROPERTY(bool blurBehind READ hasBlurBehind NOTIFY blurRegionChanged)
+    Q_PROPERTY(QVariantList blurRects READ blurRects NOTIFY blurRegionChanged)
+    Q_PROPERTY(bool contrastBehind READ hasContrastBehind NOTIFY contrastChanged)
+    Q_PROPERTY(bool textureEvicted READ isTextureEvicted NOTIFY textureEvictedChanged)
     Q_ENUMS(State)
 public:
     enum State {
@@ -59,16 +73,90 @@ public:
     QPointF globalPosition() const;
     void setGlobalPosition(const QPointF &pos);
 
+    // Move the surface right before the next frame is rendered,
+    // when called several times within a frame only the last
+    // position is applied
+    void requestGlobalPosition(const QPointF &pos);
+
     QRectF globalGeometry() const;
 
+    // Move the surface to the given output local position right
+    // away and ask the views to slide there from another position
+    void slide(Output *output, const QPointF &from, const QPointF &to);
+
+    // Region that lets what's behind the surface see through
+    // blurred, in surface local coordinates
+    bool hasBlurBehind() const;
+    QRegion blurRegion() const;
+    void setBlurRegion(const QRegion &region);
+    QVariantList blurRects() const;
+
+    // Region where what's behind the surface is shown with different
+    // contrast, intensity and saturation (1.0 leaves colors unchanged)
+    bool hasContrastBehind() const;
+    QRegion contrastRegion() const;
+    qreal contrast() const;
+    qreal intensity() const;
+    qreal saturation() const;
+    void setContrast(const QRegion &region, qreal contrast,
+                     qreal intensity, qreal saturation);
+
+    // Texture was dropped to stay within the texture budget, it's
+    // uploaded again when the surface is shown or commits; a small
+    // copy of shared memory buffers is kept meanwhile
+    bool isTextureEvicted() const;
+    QImage snapshot() const;
+
+    // Shell surfaces give their surface a role, only those enter
+    // outputs while mapped, unlike cursors and subsurfaces
+    bool hasShellRole() const;
+    void setShellRole(bool value);
+
+    // Outputs this surface was told to have entered
+    QList<Output *> enteredOutputs() const;
+
+public Q_SLOTS:
+    // Check which outputs intersect the surface and
+    // send enter or leave to the client accordingly
+    void updateOutputs();
+
 Q_SIGNALS:
     void stateChanged();
     void globalPositionChanged();
     void globalGeometryChanged();
+    void blurRegionChanged();
+    void contrastChanged();
+    // Points are in global coordinates
+    void slideRequested(const QPointF &from, const QPointF &to);
+    void textureEvictedChanged();
+
+private Q_SLOTS:
+    void applyPendingGlobalPosition();
+    void outputDestroyed(QObject *object);
+    void enterBoundOutputs();
 
 private:
     State m_state;
     QPointF m_globalPos;
+    QPointF m_pendingGlobalPos;
+    bool m_hasPendingGlobalPos;
+    QList<QPointer<QQuickWindow> > m_frameWindows;
+    QRegion m_blurRegion;
+    QRegion m_contrastRegion;
+    qreal m_contrast;
+    qreal m_intensity;
+    qreal m_saturation;
+    bool m_shellRole;
+    QSet<Output *> m_outputs;
+    QHash<Output *, QSet<wl_resource *> > m_enteredResources;
+    bool m_textureEvicted;
+    QImage m_snapshot;
+
+    void sendEnter(Output *output);
+    void sendLeave(Output *output);
+    void setTextureEvicted(bool evicted, const QImage &snapshot);
+
+    friend class TextureBudgetPrivate;
 };
 
 }
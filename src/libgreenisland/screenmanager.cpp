@@ -38,6 +38,7 @@
 #include "outputwindow.h"
 #include "quicksurface.h"
 #include "screenmanager.h"
+#include "startupmonitor.h"
 #include "windowview.h"
 
 static bool outputLess(const KScreen::OutputPtr &a, const KScreen::OutputPtr &b)
@@ -69,9 +70,10 @@ public:
     Compositor *compositor;
 
     KScreen::ConfigPtr config;
+    QHash<int, Output *> outputs;
 
     void addOutput(const KScreen::OutputPtr &output);
-    void removeOutput(const KScreen::OutputPtr &output);
+    void removeOutput(int id);
 
     void _q_outputAdded(const KScreen::OutputPtr &output);
     void _q_outputRemoved(int id);
@@ -98,6 +100,7 @@ void ScreenManagerPrivate::addOutput(const KScreen::OutputPtr &output)
 
     // Create a new window for this output
     Output *customOutput = new Output(compositor, output);
+    outputs.insert(output->id(), customOutput);
     if (output->isPrimary())
         compositor->setPrimaryOutput(customOutput);
 
@@ -107,28 +110,18 @@ void ScreenManagerPrivate::addOutput(const KScreen::OutputPtr &output)
     // Remove disabled or disconnected outputs
     q->connect(output.data(), &KScreen::Output::isEnabledChanged, [=]() {
         if (!output->isEnabled())
-            removeOutput(output);
+            removeOutput(output->id());
     });
     q->connect(output.data(), &KScreen::Output::isConnectedChanged, [=]() {
         if (!output->isConnected())
-            removeOutput(output);
+            removeOutput(output->id());
     });
 }
 
-void ScreenManagerPrivate::removeOutput(const KScreen::OutputPtr &output)
+void ScreenManagerPrivate::removeOutput(int id)
 {
-    Output *outputFound = Q_NULLPTR;
-
     // Find the output that matches KScreen's
-    for (QWaylandOutput *curOutput: compositor->outputs()) {
-        Output *customOutput = qobject_cast<Output *>(curOutput);
-        if (!customOutput)
-            continue;
-        if (customOutput->output() == output) {
-            outputFound = customOutput;
-            break;
-        }
-    }
+    Output *outputFound = outputs.value(id);
     if (!outputFound)
         return;
 
@@ -158,11 +151,12 @@ void ScreenManagerPrivate::removeOutput(const KScreen::OutputPtr &output)
     }
 
     // Delete window and output
+    outputs.remove(id);
     outputFound->window()->deleteLater();
     outputFound->deleteLater();
 
     // Debug
-    qDebug() << "Removed output" << output->name() << output->geometry();
+    qDebug() << "Removed output" << outputFound->name() << outputFound->geometry();
 }
 
 void ScreenManagerPrivate::_q_outputAdded(const KScreen::OutputPtr &output)
@@ -172,25 +166,18 @@ void ScreenManagerPrivate::_q_outputAdded(const KScreen::OutputPtr &output)
 
 void ScreenManagerPrivate::_q_outputRemoved(int id)
 {
-    if (!config.isNull())
-        removeOutput(config->outputs().value(id));
+    removeOutput(id);
 }
 
 void ScreenManagerPrivate::_q_primaryOutputChanged(const KScreen::OutputPtr &output)
 {
-    Output *newPrimary = Q_NULLPTR;
-
     // Find the output that matches KScreen's
-    for (QWaylandOutput *curOutput: compositor->outputs()) {
-        Output *customOutput = qobject_cast<Output *>(curOutput);
-        if (!customOutput)
-            continue;
-
-        // Set primary later because doing so will change the outputs list
-        // but always unset the former primary
-        if (customOutput->output() == output)
-            newPrimary = customOutput;
-        else
+    Output *newPrimary = outputs.value(output->id());
+
+    // Set primary later because doing so will change the outputs list
+    // but always unset the former primary
+    for (Output *customOutput: outputs) {
+        if (customOutput != newPrimary)
             customOutput->setPrimary(false);
     }
 
@@ -226,6 +213,7 @@ ScreenManager::ScreenManager(Compositor *compositor)
         if (d->config.isNull() || !d->config->isValid())
             qFatal("Invalid screen configuration, aborting...");
         qDebug() << "Screen configuration successfully acquired";
+        StartupMonitor::instance()->mark(QStringLiteral("screen-configuration"));
 
         // Monitor configuration
         KScreen::ConfigMonitor::instance()->addConfig(d->config);
@@ -249,9 +237,8 @@ ScreenManager::~ScreenManager()
     // Remove all outputs
     qDebug() << "Removing all outputs...";
     disconnect(d_ptr->config.data());
-    const KScreen::OutputList outputs = d_ptr->config->outputs();
-    for (const KScreen::OutputPtr &output: outputs)
-        d_ptr->removeOutput(output);
+    for (int id: d_ptr->outputs.keys())
+        d_ptr->removeOutput(id);
 
     // Remove configuration
     qDebug() << "Removing screen configuration...";
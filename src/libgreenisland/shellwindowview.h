@@ -55,10 +55,10 @@ public:
     };
 
     enum Flag {
-        PanelAlwaysVisible = 1,
-        PanelAutoHide,
-        PanelWindowsCanCover,
-        PanelWindowsGoBelow
+        PanelAlwaysVisible = 0x01,
+        PanelAutoHide = 0x02,
+        PanelWindowsCanCover = 0x04,
+        PanelWindowsGoBelow = 0x08
     };
     Q_DECLARE_FLAGS(Flags, Flag)
 
@@ -0,0 +1,160 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTimer>
+
+#include "startupmonitor.h"
+
+#include <stdio.h>
+
+namespace GreenIsland {
+
+Q_GLOBAL_STATIC(StartupMonitor, s_startupMonitor)
+
+// Start is marked as soon as the library is loaded, before main()
+// runs and QApplication loads the platform plugin and other plugins
+static void markCompositorStart()
+{
+    StartupMonitor::instance()->mark(QStringLiteral("compositor-start"));
+}
+Q_CONSTRUCTOR_FUNCTION(markCompositorStart)
+
+StartupMonitor::StartupMonitor()
+    : m_finished(false)
+    , m_benchmark(false)
+{
+    // The launcher passes the phases it recorded with the same clock
+    // we use, in the form "phase=msecs;phase=msecs"
+    const QString launcherPhases = QString::fromUtf8(qgetenv("GREENISLAND_STARTUP_PHASES"));
+    for (const QString &entry: launcherPhases.split(QLatin1Char(';'), QString::SkipEmptyParts)) {
+        const QStringList pair = entry.split(QLatin1Char('='));
+        if (pair.size() == 2)
+            m_phases.append(qMakePair(pair.at(0), pair.at(1).toLongLong()));
+    }
+
+    // In benchmark mode we quit as soon as the first frame is on screen
+    m_benchmark = qgetenv("GREENISLAND_STARTUP_BENCHMARK") == QByteArrayLiteral("1");
+
+    // Don't leak our variables to the processes started by the shell
+    qunsetenv("GREENISLAND_STARTUP_PHASES");
+    qunsetenv("GREENISLAND_STARTUP_BENCHMARK");
+}
+
+StartupMonitor *StartupMonitor::instance()
+{
+    return s_startupMonitor();
+}
+
+qint64 StartupMonitor::now()
+{
+    // Monotonic clock, the same value is read by every process
+    // on the system and therefore by the launcher too
+    QElapsedTimer timer;
+    timer.start();
+    return timer.msecsSinceReference();
+}
+
+void StartupMonitor::mark(const QString &phase)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Only the first occurrence of each phase is interesting,
+    // for example the first output window created
+    if (m_finished)
+        return;
+    for (const QPair<QString, qint64> &entry: m_phases) {
+        if (entry.first == phase)
+            return;
+    }
+
+    m_phases.append(qMakePair(phase, now()));
+}
+
+void StartupMonitor::finish()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_finished || m_phases.isEmpty())
+        return;
+    m_finished = true;
+
+    // Print the breakdown relative to the very first phase
+    const qint64 start = m_phases.first().second;
+    qint64 previous = start;
+    qint64 total = 0;
+    qDebug() << "Startup breakdown:";
+    for (const QPair<QString, qint64> &entry: m_phases) {
+        qDebug("    %-28s %6lld ms (+%lld ms)",
+               qPrintable(entry.first), entry.second - start,
+               entry.second - previous);
+        previous = entry.second;
+        total = qMax(total, entry.second - start);
+    }
+    qDebug("Startup time to first frame: %lld ms", total);
+
+    if (m_benchmark) {
+        // The launcher collects this line from the standard output
+        fprintf(stdout, "greenisland-startup-time %lld\n", total);
+        fflush(stdout);
+
+        QTimer::singleShot(0, QCoreApplication::instance(), SLOT(quit()));
+    }
+}
+
+bool StartupMonitor::isFinished() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_finished;
+}
+
+bool StartupMonitor::isBenchmark() const
+{
+    return m_benchmark;
+}
+
+QVariantList StartupMonitor::phases() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QVariantList list;
+    if (m_phases.isEmpty())
+        return list;
+
+    const qint64 start = m_phases.first().second;
+    for (const QPair<QString, qint64> &entry: m_phases) {
+        QVariantMap map;
+        map.insert(QStringLiteral("phase"), entry.first);
+        map.insert(QStringLiteral("time"), entry.second - start);
+        list.append(map);
+    }
+    return list;
+}
+
+}
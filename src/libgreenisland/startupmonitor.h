@@ -0,0 +1,63 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef GREENISLAND_STARTUPMONITOR_H
+#define GREENISLAND_STARTUPMONITOR_H
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QVariantList>
+
+namespace GreenIsland {
+
+class StartupMonitor
+{
+public:
+    StartupMonitor();
+
+    static StartupMonitor *instance();
+
+    static qint64 now();
+
+    void mark(const QString &phase);
+    void finish();
+
+    bool isFinished() const;
+    bool isBenchmark() const;
+
+    QVariantList phases() const;
+
+private:
+    mutable QMutex m_mutex;
+    QList<QPair<QString, qint64> > m_phases;
+    bool m_finished;
+    bool m_benchmark;
+};
+
+}
+
+#endif // GREENISLAND_STARTUPMONITOR_H
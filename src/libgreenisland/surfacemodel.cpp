@@ -0,0 +1,317 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QSortFilterProxyModel>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+
+#include "output.h"
+#include "quicksurface.h"
+#include "surfacemodel.h"
+
+namespace GreenIsland {
+
+/*
+ * SurfaceModelEntry
+ */
+
+struct SurfaceModelEntry
+{
+    QuickSurface *surface;
+    QHash<Output *, QPointer<QQuickItem> > windows;
+};
+
+/*
+ * OutputSurfaceModel
+ */
+
+class OutputSurfaceModel : public QSortFilterProxyModel
+{
+public:
+    OutputSurfaceModel(SurfaceModel *model, Output *output)
+        : QSortFilterProxyModel(model)
+        , m_model(model)
+        , m_output(output)
+    {
+        setSourceModel(model);
+    }
+
+    QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE
+    {
+        QHash<int, QByteArray> roles = m_model->roleNames();
+        roles[SurfaceModel::WindowRole] = "window";
+        return roles;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE
+    {
+        if (role != SurfaceModel::WindowRole)
+            return QSortFilterProxyModel::data(index, role);
+
+        QuickSurface *surface = surfaceAt(mapToSource(index).row());
+        return QVariant::fromValue(m_model->window(surface, m_output));
+    }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(sourceParent);
+        return m_model->window(surfaceAt(sourceRow), m_output) != Q_NULLPTR;
+    }
+
+private:
+    SurfaceModel *m_model;
+    Output *m_output;
+
+    QuickSurface *surfaceAt(int row) const
+    {
+        return m_model->data(m_model->index(row), SurfaceModel::SurfaceRole).value<QuickSurface *>();
+    }
+};
+
+/*
+ * SurfaceModelPrivate
+ */
+
+class SurfaceModelPrivate
+{
+public:
+    SurfaceModelPrivate(SurfaceModel *self);
+
+    void trackOutput(Output *output);
+    void removeRow(int row);
+
+    void _q_outputDestroyed(QObject *object);
+
+    QList<SurfaceModelEntry> entries;
+    QHash<QuickSurface *, int> rows;
+    QSet<Output *> outputs;
+    QHash<Output *, OutputSurfaceModel *> outputModels;
+
+private:
+    Q_DECLARE_PUBLIC(SurfaceModel)
+    SurfaceModel *const q_ptr;
+};
+
+SurfaceModelPrivate::SurfaceModelPrivate(SurfaceModel *self)
+    : q_ptr(self)
+{
+}
+
+void SurfaceModelPrivate::trackOutput(Output *output)
+{
+    Q_Q(SurfaceModel);
+
+    if (outputs.contains(output))
+        return;
+
+    outputs.insert(output);
+    q->connect(output, SIGNAL(destroyed(QObject*)),
+               q, SLOT(_q_outputDestroyed(QObject*)));
+}
+
+void SurfaceModelPrivate::removeRow(int row)
+{
+    Q_Q(SurfaceModel);
+
+    // Remove the row that actually goes away so that persistent
+    // indexes, and those of the output models, stay right
+    q->beginRemoveRows(QModelIndex(), row, row);
+    rows.remove(entries.at(row).surface);
+    entries.removeAt(row);
+    for (int i = row; i < entries.size(); i++)
+        rows[entries.at(i).surface] = i;
+    q->endRemoveRows();
+
+    Q_EMIT q->countChanged();
+}
+
+void SurfaceModelPrivate::_q_outputDestroyed(QObject *object)
+{
+    Q_Q(SurfaceModel);
+
+    // The object is being destroyed, only use it as a key
+    Output *output = static_cast<Output *>(object);
+    outputs.remove(output);
+    delete outputModels.take(output);
+
+    // Forget windows on this output, starting from the end
+    // because rows after a removed one are shifted
+    for (int row = entries.size() - 1; row >= 0; row--) {
+        SurfaceModelEntry &entry = entries[row];
+        if (entry.windows.remove(output) == 0)
+            continue;
+
+        if (entry.windows.isEmpty()) {
+            removeRow(row);
+        } else {
+            QModelIndex index = q->index(row);
+            Q_EMIT q->dataChanged(index, index);
+        }
+    }
+}
+
+/*
+ * SurfaceModel
+ */
+
+SurfaceModel::SurfaceModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , d_ptr(new SurfaceModelPrivate(this))
+{
+}
+
+SurfaceModel::~SurfaceModel()
+{
+    delete d_ptr;
+}
+
+QHash<int, QByteArray> SurfaceModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[SurfaceRole] = "surface";
+    return roles;
+}
+
+int SurfaceModel::rowCount(const QModelIndex &parent) const
+{
+    Q_D(const SurfaceModel);
+
+    if (parent.isValid())
+        return 0;
+    return d->entries.size();
+}
+
+QVariant SurfaceModel::data(const QModelIndex &index, int role) const
+{
+    Q_D(const SurfaceModel);
+
+    if (!index.isValid() || index.row() >= d->entries.size())
+        return QVariant();
+
+    if (role == SurfaceRole)
+        return QVariant::fromValue(d->entries.at(index.row()).surface);
+
+    return QVariant();
+}
+
+QQuickItem *SurfaceModel::window(QuickSurface *surface, Output *output) const
+{
+    Q_D(const SurfaceModel);
+
+    int row = d->rows.value(surface, -1);
+    if (row < 0)
+        return Q_NULLPTR;
+    return d->entries.at(row).windows.value(output);
+}
+
+void SurfaceModel::setWindow(QuickSurface *surface, Output *output, QQuickItem *window)
+{
+    Q_D(SurfaceModel);
+
+    if (!surface || !output || !window)
+        return;
+
+    d->trackOutput(output);
+
+    int row = d->rows.value(surface, -1);
+    if (row < 0) {
+        row = d->entries.size();
+
+        SurfaceModelEntry entry;
+        entry.surface = surface;
+        entry.windows.insert(output, window);
+
+        beginInsertRows(QModelIndex(), row, row);
+        d->entries.append(entry);
+        d->rows.insert(surface, row);
+        endInsertRows();
+
+        Q_EMIT countChanged();
+        return;
+    }
+
+    d->entries[row].windows.insert(output, window);
+    QModelIndex index = this->index(row);
+    Q_EMIT dataChanged(index, index);
+}
+
+QQuickItem *SurfaceModel::takeWindow(QuickSurface *surface, Output *output)
+{
+    Q_D(SurfaceModel);
+
+    int row = d->rows.value(surface, -1);
+    if (row < 0)
+        return Q_NULLPTR;
+
+    SurfaceModelEntry &entry = d->entries[row];
+    if (!entry.windows.contains(output))
+        return Q_NULLPTR;
+
+    QQuickItem *window = entry.windows.take(output);
+    if (entry.windows.isEmpty()) {
+        d->removeRow(row);
+    } else {
+        QModelIndex index = this->index(row);
+        Q_EMIT dataChanged(index, index);
+    }
+    return window;
+}
+
+QAbstractItemModel *SurfaceModel::outputModel(Output *output)
+{
+    Q_D(SurfaceModel);
+
+    if (!output)
+        return Q_NULLPTR;
+
+    OutputSurfaceModel *model = d->outputModels.value(output);
+    if (!model) {
+        model = new OutputSurfaceModel(this, output);
+        d->outputModels.insert(output, model);
+        d->trackOutput(output);
+
+        // Returned to QML but owned by us
+        QQmlEngine::setObjectOwnership(model, QQmlEngine::CppOwnership);
+    }
+    return model;
+}
+
+void SurfaceModel::removeSurface(QuickSurface *surface)
+{
+    Q_D(SurfaceModel);
+
+    int row = d->rows.value(surface, -1);
+    if (row >= 0)
+        d->removeRow(row);
+}
+
+}
+
+#include "moc_surfacemodel.cpp"
@@ -0,0 +1,82 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef SURFACEMODEL_H
+#define SURFACEMODEL_H
+
+#include <QtCore/QAbstractListModel>
+
+#include <greenisland/greenisland_export.h>
+
+class QQuickItem;
+
+namespace GreenIsland {
+
+class Output;
+class QuickSurface;
+class SurfaceModelPrivate;
+
+class GREENISLAND_EXPORT SurfaceModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+public:
+    enum Roles {
+        SurfaceRole = Qt::UserRole + 1,
+        WindowRole
+    };
+
+    SurfaceModel(QObject *parent = 0);
+    ~SurfaceModel();
+
+    QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+
+    // Window representation of a surface on the given output
+    Q_INVOKABLE QQuickItem *window(QuickSurface *surface, Output *output) const;
+    Q_INVOKABLE void setWindow(QuickSurface *surface, Output *output, QQuickItem *window);
+    Q_INVOKABLE QQuickItem *takeWindow(QuickSurface *surface, Output *output);
+
+    // Surfaces that have a window representation on the given output
+    Q_INVOKABLE QAbstractItemModel *outputModel(Output *output);
+
+    void removeSurface(QuickSurface *surface);
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    Q_DECLARE_PRIVATE(SurfaceModel)
+    SurfaceModelPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_outputDestroyed(QObject *object))
+};
+
+}
+
+#endif // SURFACEMODEL_H
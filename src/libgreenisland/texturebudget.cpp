@@ -0,0 +1,372 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtGui/QImage>
+#include <QtCompositor/QWaylandBufferRef>
+#include <QtCompositor/QWaylandSurfaceItem>
+
+#include "compositor.h"
+#include "logging.h"
+#include "quicksurface.h"
+#include "texturebudget.h"
+#include "workspacemanager.h"
+
+namespace GreenIsland {
+
+// Budget is checked every second, rates are reported less often
+static const int s_checkInterval = 1000;
+static const int s_reportInterval = 10000;
+
+// Surfaces hidden for less time than this are likely to be shown
+// again soon, for example while switching workspaces back and forth
+static const qint64 s_minimumHiddenTime = 5000;
+
+// Largest side of the snapshot kept for evicted surfaces
+static const int s_defaultSnapshotSize = 256;
+
+class TextureBudgetPrivate;
+
+/*
+ * TextureBudgetAttacher
+ */
+
+// Sits between the surface and the attacher of QWaylandQuickSurface,
+// which owns the texture, so that the texture can be dropped and
+// uploaded again from the last buffer the client committed
+class TextureBudgetAttacher : public QWaylandBufferAttacher
+{
+public:
+    TextureBudgetAttacher(QuickSurface *surface, TextureBudgetPrivate *budget);
+
+    void attach(const QWaylandBufferRef &ref) Q_DECL_OVERRIDE;
+
+    QuickSurface *surface;
+    TextureBudgetPrivate *budget;
+    QWaylandBufferAttacher *attacher;
+    QWaylandBufferRef bufferRef;
+    bool evicted;
+
+    // Snapshot of the last eviction, valid until the next commit
+    QImage snapshot;
+};
+
+/*
+ * TextureBudgetPrivate
+ */
+
+class TextureBudgetPrivate
+{
+public:
+    TextureBudgetPrivate(TextureBudget *self);
+
+    qint64 textureBytes(QuickSurface *surface) const;
+
+    void evict(TextureBudgetAttacher *attacher);
+    void restore(TextureBudgetAttacher *attacher);
+    void restored(TextureBudgetAttacher *attacher);
+    void report(qint64 used);
+
+    void _q_check();
+    void _q_restoreVisible();
+
+    Compositor *compositor;
+    qint64 budget;
+    int snapshotSize;
+
+    QHash<QuickSurface *, TextureBudgetAttacher *> attachers;
+
+    // When surfaces were first seen hidden, on the clock below
+    QElapsedTimer clock;
+    QHash<QuickSurface *, qint64> hiddenSince;
+
+    QTimer *checkTimer;
+
+    // Rates reported to the log
+    QElapsedTimer reportTimer;
+    int evictions;
+    int restores;
+
+protected:
+    Q_DECLARE_PUBLIC(TextureBudget)
+    TextureBudget *const q_ptr;
+};
+
+TextureBudgetAttacher::TextureBudgetAttacher(QuickSurface *surface, TextureBudgetPrivate *budget)
+    : surface(surface)
+    , budget(budget)
+    , attacher(surface->bufferAttacher())
+    , evicted(false)
+{
+}
+
+void TextureBudgetAttacher::attach(const QWaylandBufferRef &ref)
+{
+    bufferRef = ref;
+    snapshot = QImage();
+
+    // Clients keep committing while hidden, only keep the last buffer
+    // and bring the texture back when the surface is actually shown
+    if (evicted) {
+        if (!budget->compositor->visibleSurfaces().contains(surface))
+            return;
+        budget->restored(this);
+    }
+
+    attacher->attach(ref);
+}
+
+TextureBudgetPrivate::TextureBudgetPrivate(TextureBudget *self)
+    : compositor(Q_NULLPTR)
+    , budget(0)
+    , snapshotSize(s_defaultSnapshotSize)
+    , evictions(0)
+    , restores(0)
+    , q_ptr(self)
+{
+    clock.start();
+    reportTimer.start();
+
+    checkTimer = new QTimer(self);
+    checkTimer->setInterval(s_checkInterval);
+    self->connect(checkTimer, SIGNAL(timeout()),
+                  self, SLOT(_q_check()));
+}
+
+qint64 TextureBudgetPrivate::textureBytes(QuickSurface *surface) const
+{
+    // Textures are uploaded as 32 bits per pixel
+    return qint64(surface->size().width()) * surface->size().height() * 4;
+}
+
+void TextureBudgetPrivate::evict(TextureBudgetAttacher *attacher)
+{
+    // Only shared memory buffers can be read back, other buffers
+    // are shown again as soon as they are uploaded; the snapshot is
+    // not scaled again when the buffer didn't change since then
+    if (attacher->snapshot.isNull() && snapshotSize > 0 && attacher->bufferRef.isShm()) {
+        QImage image = attacher->bufferRef.image();
+        if (image.width() > snapshotSize || image.height() > snapshotSize)
+            attacher->snapshot = image.scaled(snapshotSize, snapshotSize, Qt::KeepAspectRatio,
+                                              Qt::SmoothTransformation);
+        else
+            attacher->snapshot = image.copy();
+    }
+
+    // The last buffer is kept to upload it again later
+    attacher->evicted = true;
+    attacher->attacher->attach(QWaylandBufferRef());
+    attacher->surface->setTextureEvicted(true, attacher->snapshot);
+    evictions++;
+}
+
+void TextureBudgetPrivate::restore(TextureBudgetAttacher *attacher)
+{
+    if (!attacher->evicted)
+        return;
+
+    restored(attacher);
+    attacher->attacher->attach(attacher->bufferRef);
+
+    // The texture is uploaded when the next frame is synchronized
+    for (QWaylandSurfaceView *view: attacher->surface->views())
+        static_cast<QWaylandSurfaceItem *>(view)->update();
+}
+
+void TextureBudgetPrivate::restored(TextureBudgetAttacher *attacher)
+{
+    attacher->evicted = false;
+    attacher->surface->setTextureEvicted(false, QImage());
+    if (attacher->bufferRef)
+        restores++;
+}
+
+void TextureBudgetPrivate::report(qint64 used)
+{
+    qint64 elapsed = reportTimer.elapsed();
+    if (elapsed < s_reportInterval)
+        return;
+
+    if (evictions > 0 || restores > 0) {
+        qreal seconds = elapsed / 1000.0;
+        qCDebug(GREENISLAND_COMPOSITOR,
+                "Texture budget: %lld of %lld KiB used, %.2f evictions/s, %.2f restores/s",
+                used / 1024, budget / 1024, evictions / seconds, restores / seconds);
+    }
+
+    evictions = 0;
+    restores = 0;
+    reportTimer.restart();
+}
+
+void TextureBudgetPrivate::_q_check()
+{
+    const QSet<QWaylandSurface *> visible = compositor->visibleSurfaces().toSet();
+    const qint64 now = clock.elapsed();
+
+    qint64 used = 0;
+    QList<QuickSurface *> candidates;
+
+    for (TextureBudgetAttacher *attacher: attachers) {
+        QuickSurface *surface = attacher->surface;
+
+        // Cursor surfaces get an attacher of their own
+        if (surface->bufferAttacher() != attacher)
+            continue;
+
+        if (visible.contains(surface))
+            hiddenSince.remove(surface);
+        else if (!hiddenSince.contains(surface))
+            hiddenSince.insert(surface, now);
+
+        if (attacher->evicted || !attacher->bufferRef)
+            continue;
+
+        used += textureBytes(surface);
+        if (hiddenSince.contains(surface) && now - hiddenSince.value(surface) >= s_minimumHiddenTime)
+            candidates.append(surface);
+    }
+
+    // Evict what has been hidden for the longest time first
+    if (used > budget) {
+        std::sort(candidates.begin(), candidates.end(), [this](QuickSurface *a, QuickSurface *b) {
+            return hiddenSince.value(a) < hiddenSince.value(b);
+        });
+
+        for (QuickSurface *surface: candidates) {
+            if (used <= budget)
+                break;
+            used -= textureBytes(surface);
+            evict(attachers.value(surface));
+        }
+    }
+
+    report(used);
+}
+
+void TextureBudgetPrivate::_q_restoreVisible()
+{
+    const QSet<QWaylandSurface *> visible = compositor->visibleSurfaces().toSet();
+
+    for (TextureBudgetAttacher *attacher: attachers) {
+        if (!attacher->evicted)
+            continue;
+
+        if (visible.contains(attacher->surface)) {
+            hiddenSince.remove(attacher->surface);
+            restore(attacher);
+        }
+    }
+}
+
+/*
+ * TextureBudget
+ */
+
+TextureBudget::TextureBudget(Compositor *compositor)
+    : QObject(compositor)
+    , d_ptr(new TextureBudgetPrivate(this))
+{
+    Q_D(TextureBudget);
+    d->compositor = compositor;
+
+    // Budget in MiB, no limit unless set
+    setBudget(qgetenv("GREENISLAND_TEXTURE_BUDGET").toLongLong() * 1024 * 1024);
+
+    // Snapshots of evicted surfaces are not kept when set to 0
+    bool ok = false;
+    int snapshotSize = qgetenv("GREENISLAND_TEXTURE_SNAPSHOT_SIZE").toInt(&ok);
+    if (ok)
+        d->snapshotSize = qMax(0, snapshotSize);
+
+    // Restore textures as soon as surfaces are shown again
+    connect(compositor->workspaceManager(), SIGNAL(workspaceSelected(int)),
+            this, SLOT(_q_restoreVisible()));
+}
+
+TextureBudget::~TextureBudget()
+{
+    qDeleteAll(d_ptr->attachers);
+    delete d_ptr;
+}
+
+qint64 TextureBudget::budget() const
+{
+    Q_D(const TextureBudget);
+    return d->budget;
+}
+
+void TextureBudget::setBudget(qint64 bytes)
+{
+    Q_D(TextureBudget);
+
+    bytes = qMax(Q_INT64_C(0), bytes);
+    if (d->budget == bytes)
+        return;
+
+    d->budget = bytes;
+
+    // Without a limit all textures are kept
+    if (d->budget > 0) {
+        d->checkTimer->start();
+    } else {
+        d->checkTimer->stop();
+        for (TextureBudgetAttacher *attacher: d->attachers)
+            d->restore(attacher);
+    }
+}
+
+void TextureBudget::addSurface(QuickSurface *surface)
+{
+    Q_D(TextureBudget);
+
+    TextureBudgetAttacher *attacher = new TextureBudgetAttacher(surface, d);
+    surface->setBufferAttacher(attacher);
+    d->attachers.insert(surface, attacher);
+
+    connect(surface, SIGNAL(visibilityChanged()),
+            this, SLOT(_q_restoreVisible()));
+    connect(surface, &QWaylandSurface::surfaceDestroyed, this, [=]() {
+        // Buffers go away with the surface
+        attacher->bufferRef = QWaylandBufferRef();
+        attacher->snapshot = QImage();
+        attacher->evicted = false;
+    });
+    connect(surface, &QObject::destroyed, this, [=]() {
+        Q_D(TextureBudget);
+        d->hiddenSince.remove(surface);
+        delete d->attachers.take(surface);
+    });
+}
+
+}
+
+#include "moc_texturebudget.cpp"
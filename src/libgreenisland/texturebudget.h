@@ -0,0 +1,63 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef TEXTUREBUDGET_H
+#define TEXTUREBUDGET_H
+
+#include <QtCore/QObject>
+
+namespace GreenIsland {
+
+class Compositor;
+class QuickSurface;
+class TextureBudgetPrivate;
+
+class TextureBudget : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TextureBudget(Compositor *compositor);
+    ~TextureBudget();
+
+    // Memory surface textures may take, in bytes (0 means no limit)
+    qint64 budget() const;
+    void setBudget(qint64 bytes);
+
+    // Track the surface textures, evict them when the surface has
+    // been hidden for a while and the budget is exceeded
+    void addSurface(QuickSurface *surface);
+
+private:
+    Q_DECLARE_PRIVATE(TextureBudget)
+    TextureBudgetPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_check())
+    Q_PRIVATE_SLOT(d_func(), void _q_restoreVisible())
+};
+
+}
+
+#endif // TEXTUREBUDGET_H
@@ -0,0 +1,287 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QHash>
+#include <QtCore/QRect>
+
+#include "compositor.h"
+#include "output.h"
+#include "outputlayout.h"
+#include "quicksurface.h"
+#include "windowplacement.h"
+
+// Fragmented desktops can produce lots of free rectangles,
+// only the biggest ones are worth keeping
+static const int s_maxFreeRects = 128;
+
+// Offset between windows when there's no free space left
+static const int s_cascadeOffset = 32;
+
+static bool areaGreaterThan(const QRect &a, const QRect &b)
+{
+    return a.width() * a.height() > b.width() * b.height();
+}
+
+namespace GreenIsland {
+
+/*
+ * WindowPlacementPrivate
+ */
+
+class WindowPlacementPrivate
+{
+public:
+    WindowPlacementPrivate(WindowPlacement *self);
+
+    QList<QRect> &freeRects(Output *output, QuickSurface *ignored);
+
+    static QPoint placeIn(QList<QRect> &rects, const QRect &available,
+                          QPoint &cascade, const QSize &size);
+    static void reserve(QList<QRect> &rects, const QRect &used);
+
+    void _q_surfaceGeometryChanged();
+    void _q_surfaceUnmapped();
+
+    Compositor *compositor;
+
+    // Maximal free rectangles of each output, computed
+    // on demand and updated when a window is placed
+    QHash<Output *, QList<QRect> > freeSpace;
+    QHash<Output *, QPoint> cascade;
+
+    // Areas reserved for placed windows that didn't move there yet
+    QHash<QuickSurface *, QRect> placed;
+
+    // Initial position of each mapped surface, every output asks
+    // for it but the window is placed only once
+    QHash<QuickSurface *, QPointF> positions;
+
+private:
+    Q_DECLARE_PUBLIC(WindowPlacement)
+    WindowPlacement *const q_ptr;
+};
+
+WindowPlacementPrivate::WindowPlacementPrivate(WindowPlacement *self)
+    : compositor(Q_NULLPTR)
+    , q_ptr(self)
+{
+}
+
+QList<QRect> &WindowPlacementPrivate::freeRects(Output *output, QuickSurface *ignored)
+{
+    if (freeSpace.contains(output))
+        return freeSpace[output];
+
+    QRect available = compositor->outputLayout()->availableGeometry(output);
+
+    QList<QRect> &rects = freeSpace[output];
+    rects.append(available);
+
+    // Subtract mapped toplevel windows
+    for (QWaylandSurface *surface: compositor->surfaces()) {
+        QuickSurface *quickSurface = qobject_cast<QuickSurface *>(surface);
+        if (!quickSurface || quickSurface == ignored || !quickSurface->isMapped())
+            continue;
+        if (quickSurface->windowType() != QWaylandSurface::Toplevel)
+            continue;
+        if (quickSurface->visibility() == QWindow::Minimized)
+            continue;
+
+        QRect geometry = quickSurface->globalGeometry().toAlignedRect();
+        if (geometry.intersects(available))
+            reserve(rects, geometry);
+    }
+
+    return rects;
+}
+
+QPoint WindowPlacementPrivate::placeIn(QList<QRect> &rects, const QRect &available,
+                                       QPoint &cascade, const QSize &size)
+{
+    // Place the window in the largest free area that can hold it,
+    // rectangles are sorted by area
+    QPoint pos;
+    bool found = false;
+    for (const QRect &rect: rects) {
+        if (rect.width() >= size.width() && rect.height() >= size.height()) {
+            pos = rect.topLeft();
+            found = true;
+            break;
+        }
+    }
+
+    // Cascade windows when the output is full
+    if (!found) {
+        if (available.x() + cascade.x() + size.width() > available.right() ||
+                available.y() + cascade.y() + size.height() > available.bottom())
+            cascade = QPoint(0, 0);
+        pos = available.topLeft() + cascade;
+        cascade += QPoint(s_cascadeOffset, s_cascadeOffset);
+    }
+
+    // Windows mapped in a burst are placed one after another before
+    // any of them moves, account for this one right away
+    reserve(rects, QRect(pos, size));
+
+    return pos;
+}
+
+void WindowPlacementPrivate::reserve(QList<QRect> &rects, const QRect &used)
+{
+    // Split each free rectangle intersecting the used area into the
+    // (up to four) maximal rectangles around it
+    QList<QRect> result;
+    for (const QRect &rect: rects) {
+        if (!rect.intersects(used)) {
+            result.append(rect);
+            continue;
+        }
+
+        if (used.left() > rect.left())
+            result.append(QRect(rect.left(), rect.top(),
+                                used.left() - rect.left(), rect.height()));
+        if (used.right() < rect.right())
+            result.append(QRect(used.right() + 1, rect.top(),
+                                rect.right() - used.right(), rect.height()));
+        if (used.top() > rect.top())
+            result.append(QRect(rect.left(), rect.top(),
+                                rect.width(), used.top() - rect.top()));
+        if (used.bottom() < rect.bottom())
+            result.append(QRect(rect.left(), used.bottom() + 1,
+                                rect.width(), rect.bottom() - used.bottom()));
+    }
+
+    // Drop rectangles contained by others, bigger ones go first
+    // so that we only need to look backwards
+    qSort(result.begin(), result.end(), areaGreaterThan);
+    rects.clear();
+    for (const QRect &rect: result) {
+        bool contained = false;
+        for (const QRect &other: rects) {
+            if (other.contains(rect)) {
+                contained = true;
+                break;
+            }
+        }
+        if (!contained)
+            rects.append(rect);
+        if (rects.size() == s_maxFreeRects)
+            break;
+    }
+}
+
+void WindowPlacementPrivate::_q_surfaceGeometryChanged()
+{
+    Q_Q(WindowPlacement);
+
+    // Free space was already updated when the window was placed
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (surface && placed.contains(surface)) {
+        QRect geometry = placed.take(surface);
+        if (geometry == surface->globalGeometry().toAlignedRect())
+            return;
+    }
+
+    q->invalidate();
+}
+
+void WindowPlacementPrivate::_q_surfaceUnmapped()
+{
+    Q_Q(WindowPlacement);
+
+    // Place the window again the next time it's mapped
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (surface) {
+        placed.remove(surface);
+        positions.remove(surface);
+    }
+
+    q->invalidate();
+}
+
+/*
+ * WindowPlacement
+ */
+
+WindowPlacement::WindowPlacement(Compositor *compositor)
+    : QObject(compositor)
+    , d_ptr(new WindowPlacementPrivate(this))
+{
+    Q_D(WindowPlacement);
+    d->compositor = compositor;
+
+    connect(compositor->outputLayout(), SIGNAL(layoutChanged()),
+            this, SLOT(invalidate()));
+}
+
+WindowPlacement::~WindowPlacement()
+{
+    delete d_ptr;
+}
+
+QPointF WindowPlacement::place(QuickSurface *surface, Output *output)
+{
+    Q_D(WindowPlacement);
+
+    // Already placed by the first output that asked
+    if (d->positions.contains(surface))
+        return d->positions.value(surface);
+
+    QRect available = d->compositor->outputLayout()->availableGeometry(output);
+    QList<QRect> &rects = d->freeRects(output, surface);
+    QPoint pos = d->placeIn(rects, available, d->cascade[output], surface->size());
+
+    d->placed.insert(surface, QRect(pos, surface->size()));
+    d->positions.insert(surface, pos);
+
+    return pos;
+}
+
+void WindowPlacement::addSurface(QuickSurface *surface)
+{
+    connect(surface, SIGNAL(globalGeometryChanged()),
+            this, SLOT(_q_surfaceGeometryChanged()));
+    connect(surface, SIGNAL(unmapped()),
+            this, SLOT(_q_surfaceUnmapped()));
+    connect(surface, SIGNAL(visibilityChanged()),
+            this, SLOT(invalidate()));
+    connect(surface, &QObject::destroyed, this, [=]() {
+        Q_D(WindowPlacement);
+        d->placed.remove(surface);
+        d->positions.remove(surface);
+        invalidate();
+    });
+}
+
+void WindowPlacement::invalidate()
+{
+    Q_D(WindowPlacement);
+    d->freeSpace.clear();
+}
+
+}
+
+#include "moc_windowplacement.cpp"
@@ -0,0 +1,68 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef WINDOWPLACEMENT_H
+#define WINDOWPLACEMENT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QPointF>
+
+namespace GreenIsland {
+
+class Compositor;
+class Output;
+class QuickSurface;
+class WindowPlacementPrivate;
+
+class WindowPlacement : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WindowPlacement(Compositor *compositor);
+    ~WindowPlacement();
+
+    // Global position for a new toplevel window on the given output,
+    // the same position is returned until the surface is unmapped
+    QPointF place(QuickSurface *surface, Output *output);
+
+    // Compute free space again when the surface changes
+    void addSurface(QuickSurface *surface);
+
+public Q_SLOTS:
+    // Free space has to be computed again
+    void invalidate();
+
+private:
+    Q_DECLARE_PRIVATE(WindowPlacement)
+    WindowPlacementPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_surfaceGeometryChanged())
+    Q_PRIVATE_SLOT(d_func(), void _q_surfaceUnmapped())
+};
+
+}
+
+#endif // WINDOWPLACEMENT_H
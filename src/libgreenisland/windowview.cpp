@@ -27,10 +27,9 @@
 #include <QtCompositor/QWaylandCompositor>
 #include <QtCompositor/QWaylandOutput>
 #include <QtCompositor/QWaylandSurface>
-#include <QtCompositor/private/qwloutput_p.h>
-#include <QtCompositor/private/qwlsurface_p.h>
 
 #include "compositor.h"
+#include "outputlayout.h"
 #include "quicksurface.h"
 #include "windowview.h"
 
@@ -41,7 +40,8 @@ WindowView::WindowView(QuickSurface *surface, Output *output, QQuickItem *parent
     , m_surface(surface)
     , m_output(output)
 {
-    // Change window position and send enter/leave events to the output
+    // Change window position, enter and leave events
+    // are sent by the surface
     connect(m_surface, &QuickSurface::globalGeometryChanged, [=]() {
         // WindowView is a child of the QtQuick window representation that is
         // the one who holds the position on screen
@@ -49,14 +49,6 @@ WindowView::WindowView(QuickSurface *surface, Output *output, QQuickItem *parent
             parentItem()->setPosition(m_output->mapToOutput(m_surface->globalPosition()));
         else
             qWarning("Unable to move this view because it has no window representation");
-
-        // Global position is changed every time the window is moved,
-        // check against output geometry to see if it enters or leave
-        // the output
-        if (QRectF(m_output->geometry()).intersects(m_surface->globalGeometry()))
-            sendEnter(m_output);
-        else
-            sendLeave(m_output);
     });
 }
 
@@ -86,22 +78,7 @@ Output *WindowView::mainOutput() const
     // present windows to present only windows for the output it is
     // running on (effects run once for each output)
     QRectF geometry(m_surface->globalPosition(), QSizeF(width(), height()));
-    int maxArea = 0, area = 0;
-    QWaylandOutput *main = Q_NULLPTR;
-
-    for (QWaylandOutput *output: compositor()->outputs()) {
-        QRectF intersection = QRectF(output->geometry()).intersected(geometry);
-
-        if (intersection.isValid()) {
-            area = intersection.width() * intersection.height();
-            if (area >= maxArea) {
-                main = output;
-                maxArea = area;
-            }
-        }
-    }
-
-    return qobject_cast<Output *>(main);
+    return static_cast<Compositor *>(compositor())->outputLayout()->mainOutputFor(geometry);
 }
 
 void WindowView::mousePressEvent(QMouseEvent *event)
@@ -113,22 +90,6 @@ void WindowView::mousePressEvent(QMouseEvent *event)
     QWaylandSurfaceItem::mousePressEvent(event);
 }
 
-void WindowView::sendEnter(Output *output)
-{
-    //qDebug() << "Enter" << output;
-
-    for (QtWayland::Output::Resource *resource: output->handle()->resourceMap().values())
-        surface()->handle()->send_enter(resource->handle);
-}
-
-void WindowView::sendLeave(Output *output)
-{
-    //qDebug() << "Leave" << output;
-
-    for (QtWayland::Output::Resource *resource: output->handle()->resourceMap().values())
-        surface()->handle()->send_leave(resource->handle);
-}
-
 }
 
 #include "moc_windowview.cpp"
@@ -59,9 +59,6 @@ protected:
 private:
     QuickSurface *m_surface;
     Output *m_output;
-
-    void sendEnter(Output *output);
-    void sendLeave(Output *output);
 };
 
 }
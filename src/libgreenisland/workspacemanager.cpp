@@ -0,0 +1,312 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QHash>
+
+#include "compositor.h"
+#include "quicksurface.h"
+#include "workspacemanager.h"
+
+namespace GreenIsland {
+
+/*
+ * WorkspaceManagerPrivate
+ */
+
+class WorkspaceManagerPrivate
+{
+public:
+    WorkspaceManagerPrivate(WorkspaceManager *self);
+
+    int windowCount(int index) const;
+    void rowChanged(int index);
+
+    void _q_surfaceMapped();
+
+    int count;
+    int current;
+    int previous;
+
+    // Workspace of each toplevel surface
+    QHash<QWaylandSurface *, int> workspaces;
+
+protected:
+    Q_DECLARE_PUBLIC(WorkspaceManager)
+    WorkspaceManager *const q_ptr;
+};
+
+WorkspaceManagerPrivate::WorkspaceManagerPrivate(WorkspaceManager *self)
+    : count(1)
+    , current(0)
+    , previous(-1)
+    , q_ptr(self)
+{
+}
+
+int WorkspaceManagerPrivate::windowCount(int index) const
+{
+    int n = 0;
+    for (int workspace: workspaces) {
+        if (workspace == index)
+            n++;
+    }
+    return n;
+}
+
+void WorkspaceManagerPrivate::rowChanged(int index)
+{
+    Q_Q(WorkspaceManager);
+
+    if (index < 0 || index >= count)
+        return;
+
+    QModelIndex modelIndex = q->index(index);
+    Q_EMIT q->dataChanged(modelIndex, modelIndex);
+}
+
+void WorkspaceManagerPrivate::_q_surfaceMapped()
+{
+    Q_Q(WorkspaceManager);
+
+    QuickSurface *surface = qobject_cast<QuickSurface *>(q->sender());
+    if (!surface)
+        return;
+
+    // Transients and popups follow their parent, surfaces
+    // that were mapped before keep their workspace
+    if (surface->windowType() != QWaylandSurface::Toplevel)
+        return;
+    if (workspaces.contains(surface))
+        return;
+
+    q->assign(surface, current);
+}
+
+/*
+ * WorkspaceManager
+ */
+
+WorkspaceManager::WorkspaceManager(Compositor *compositor)
+    : QAbstractListModel(compositor)
+    , d_ptr(new WorkspaceManagerPrivate(this))
+{
+}
+
+WorkspaceManager::~WorkspaceManager()
+{
+    delete d_ptr;
+}
+
+QHash<int, QByteArray> WorkspaceManager::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[CurrentRole] = "current";
+    roles[WindowCountRole] = "windowCount";
+    return roles;
+}
+
+int WorkspaceManager::rowCount(const QModelIndex &parent) const
+{
+    Q_D(const WorkspaceManager);
+
+    if (parent.isValid())
+        return 0;
+    return d->count;
+}
+
+QVariant WorkspaceManager::data(const QModelIndex &index, int role) const
+{
+    Q_D(const WorkspaceManager);
+
+    if (!index.isValid() || index.row() >= d->count)
+        return QVariant();
+
+    switch (role) {
+    case CurrentRole:
+        return index.row() == d->current;
+    case WindowCountRole:
+        return d->windowCount(index.row());
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+int WorkspaceManager::currentIndex() const
+{
+    Q_D(const WorkspaceManager);
+    return d->current;
+}
+
+int WorkspaceManager::previousIndex() const
+{
+    Q_D(const WorkspaceManager);
+    return d->previous;
+}
+
+void WorkspaceManager::add()
+{
+    Q_D(WorkspaceManager);
+
+    int index = d->count;
+    beginInsertRows(QModelIndex(), index, index);
+    d->count++;
+    endInsertRows();
+
+    Q_EMIT countChanged();
+    Q_EMIT workspaceAdded(index);
+}
+
+void WorkspaceManager::remove(int index)
+{
+    Q_D(WorkspaceManager);
+
+    // There's always at least one workspace
+    if (index < 0 || index >= d->count || d->count == 1)
+        return;
+
+    // Move windows to the previous workspace, or the next one
+    // if this is the first; windows are reparented by the shell
+    // before the workspace goes away
+    int target = index == 0 ? 1 : index - 1;
+    for (QWaylandSurface *surface: d->workspaces.keys()) {
+        if (d->workspaces.value(surface) == index)
+            assign(qobject_cast<QuickSurface *>(surface), target);
+    }
+
+    beginRemoveRows(QModelIndex(), index, index);
+    d->count--;
+    for (auto it = d->workspaces.begin(); it != d->workspaces.end(); ++it) {
+        if (it.value() > index)
+            it.value()--;
+    }
+    endRemoveRows();
+
+    if (d->previous == index)
+        d->previous = -1;
+    else if (d->previous > index)
+        d->previous--;
+
+    Q_EMIT countChanged();
+    Q_EMIT workspaceRemoved(index);
+
+    // Windows that were shown are now on the target workspace
+    if (d->current > index) {
+        d->current--;
+        Q_EMIT workspaceSelected(d->current);
+    } else if (d->current == index) {
+        d->current = qMax(0, index - 1);
+        d->rowChanged(d->current);
+        Q_EMIT workspaceSelected(d->current);
+    }
+}
+
+void WorkspaceManager::select(int index)
+{
+    Q_D(WorkspaceManager);
+
+    if (index < 0 || index >= d->count || index == d->current)
+        return;
+
+    d->previous = d->current;
+    d->current = index;
+    d->rowChanged(d->previous);
+    d->rowChanged(index);
+
+    Q_EMIT workspaceSelected(index);
+}
+
+void WorkspaceManager::selectPrevious()
+{
+    Q_D(WorkspaceManager);
+    select(d->current > 0 ? d->current - 1 : d->count - 1);
+}
+
+void WorkspaceManager::selectNext()
+{
+    Q_D(WorkspaceManager);
+    select(d->current < d->count - 1 ? d->current + 1 : 0);
+}
+
+int WorkspaceManager::workspaceOf(QuickSurface *surface) const
+{
+    Q_D(const WorkspaceManager);
+    return d->workspaces.value(surface, -1);
+}
+
+void WorkspaceManager::assign(QuickSurface *surface, int index)
+{
+    Q_D(WorkspaceManager);
+
+    if (!surface || index < 0 || index >= d->count)
+        return;
+
+    int previous = d->workspaces.value(surface, -1);
+    if (previous == index)
+        return;
+
+    d->workspaces.insert(surface, index);
+    d->rowChanged(previous);
+    d->rowChanged(index);
+
+    Q_EMIT surfaceAssigned(surface, index);
+}
+
+bool WorkspaceManager::isOnCurrentWorkspace(QWaylandSurface *surface) const
+{
+    Q_D(const WorkspaceManager);
+
+    // Transients and popups are shown along with their toplevel
+    while (surface && surface->transientParent())
+        surface = surface->transientParent();
+    if (!surface)
+        return true;
+
+    int index = d->workspaces.value(surface, -1);
+    return index < 0 || index == d->current;
+}
+
+void WorkspaceManager::addSurface(QuickSurface *surface)
+{
+    connect(surface, SIGNAL(mapped()),
+            this, SLOT(_q_surfaceMapped()));
+}
+
+void WorkspaceManager::removeSurface(QuickSurface *surface)
+{
+    Q_D(WorkspaceManager);
+
+    if (!surface || !d->workspaces.contains(surface))
+        return;
+
+    int index = d->workspaces.take(surface);
+    d->rowChanged(index);
+}
+
+}
+
+#include "moc_workspacemanager.cpp"
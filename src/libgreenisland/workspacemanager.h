@@ -0,0 +1,101 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#ifndef WORKSPACEMANAGER_H
+#define WORKSPACEMANAGER_H
+
+#include <QtCore/QAbstractListModel>
+
+#include <greenisland/greenisland_export.h>
+
+class QWaylandSurface;
+
+namespace GreenIsland {
+
+class Compositor;
+class QuickSurface;
+class WorkspaceManagerPrivate;
+
+class GREENISLAND_EXPORT WorkspaceManager : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int currentIndex READ currentIndex WRITE select NOTIFY workspaceSelected)
+    Q_PROPERTY(int previousIndex READ previousIndex NOTIFY workspaceSelected)
+public:
+    enum Roles {
+        CurrentRole = Qt::UserRole + 1,
+        WindowCountRole
+    };
+
+    explicit WorkspaceManager(Compositor *compositor);
+    ~WorkspaceManager();
+
+    QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+
+    int currentIndex() const;
+
+    // Workspace selected before the current one, -1 if none
+    int previousIndex() const;
+
+    Q_INVOKABLE void add();
+    Q_INVOKABLE void remove(int index);
+    Q_INVOKABLE void select(int index);
+    Q_INVOKABLE void selectPrevious();
+    Q_INVOKABLE void selectNext();
+
+    // Workspace of a toplevel surface, -1 if not assigned
+    Q_INVOKABLE int workspaceOf(QuickSurface *surface) const;
+    Q_INVOKABLE void assign(QuickSurface *surface, int index);
+
+    // Whether the surface, or the toplevel it belongs to, is on the
+    // current workspace; surfaces without a workspace always are
+    bool isOnCurrentWorkspace(QWaylandSurface *surface) const;
+
+    // Toplevel surfaces are assigned to the current workspace when mapped
+    void addSurface(QuickSurface *surface);
+    void removeSurface(QuickSurface *surface);
+
+Q_SIGNALS:
+    void countChanged();
+    void workspaceAdded(int index);
+    void workspaceRemoved(int index);
+    void workspaceSelected(int index);
+    void surfaceAssigned(QuickSurface *surface, int index);
+
+private:
+    Q_DECLARE_PRIVATE(WorkspaceManager)
+    WorkspaceManagerPrivate *const d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void _q_surfaceMapped())
+};
+
+}
+
+#endif // WORKSPACEMANAGER_H
@@ -0,0 +1,266 @@
+/****************************************************************************
+ * This file is part of Green Island.
+ *
+ * Copyright (C) 2014 Pier Luigi Fiorini <pierluigi.fiorini@gmail.com>
+ *
+ * Author(s):
+ *    Pier Luigi Fiorini
+ *
+ * $BEGIN_LICENSE:GPL2+$
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * $END_LICENSE$
+ ***************************************************************************/
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtWidgets/QApplication>
+
+#include <greenisland/compositor.h>
+
+#include <wayland-client.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace GreenIsland;
+
+static const char *s_socket = "greenisland-placement-benchmark";
+
+// Largest window mapped by the client, see windowSize()
+static const int s_maxWidth = 600;
+static const int s_maxHeight = 450;
+
+// Mix of window sizes that fills a 1920x1080 output after a few
+// dozen windows, the rest are cascaded
+static QSize windowSize(int i)
+{
+    return QSize(200 + (i * 37) % 400, 150 + (i * 53) % 300);
+}
+
+/*
+ * Globals
+ */
+
+struct Globals
+{
+    wl_compositor *compositor;
+    wl_shm *shm;
+};
+
+static void registryGlobal(void *data, wl_registry *registry, uint32_t name,
+                           const char *interface, uint32_t version)
+{
+    Q_UNUSED(version);
+
+    Globals *globals = static_cast<Globals *>(data);
+    if (strcmp(interface, wl_compositor_interface.name) == 0)
+        globals->compositor = static_cast<wl_compositor *>(
+                    wl_registry_bind(registry, name, &wl_compositor_interface, 1));
+    else if (strcmp(interface, wl_shm_interface.name) == 0)
+        globals->shm = static_cast<wl_shm *>(
+                    wl_registry_bind(registry, name, &wl_shm_interface, 1));
+}
+
+static void registryGlobalRemove(void *data, wl_registry *registry, uint32_t name)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(registry);
+    Q_UNUSED(name);
+}
+
+static const wl_registry_listener s_registryListener = {
+    registryGlobal,
+    registryGlobalRemove
+};
+
+/*
+ * Client
+ */
+
+// Commits buffers to surfaces without a shell role from its own thread,
+// the shell doesn't map nor place them so the benchmark is the first to
+// ask for their position; the connection is kept until finish() is called
+class Client : public QThread
+{
+public:
+    Client(int count);
+
+    bool isMapped() const;
+    void finish();
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    int m_count;
+    QAtomicInt m_mapped;
+    QSemaphore m_finished;
+};
+
+Client::Client(int count)
+    : m_count(count)
+    , m_mapped(0)
+{
+}
+
+bool Client::isMapped() const
+{
+    return m_mapped.load() != 0;
+}
+
+void Client::finish()
+{
+    m_finished.release();
+}
+
+void Client::run()
+{
+    wl_display *display = wl_display_connect(s_socket);
+    if (!display) {
+        qWarning("Unable to connect to \"%s\"", s_socket);
+        return;
+    }
+
+    Globals globals = { Q_NULLPTR, Q_NULLPTR };
+    wl_registry *registry = wl_display_get_registry(display);
+    wl_registry_add_listener(registry, &s_registryListener, &globals);
+    wl_display_roundtrip(display);
+    if (!globals.compositor || !globals.shm) {
+        qWarning("Compositor or shared memory global not found");
+        wl_display_disconnect(display);
+        return;
+    }
+
+    // All buffers come from the same memory, contents don't matter
+    const int stride = s_maxWidth * 4;
+    const int poolSize = stride * s_maxHeight;
+    QByteArray path = qgetenv("XDG_RUNTIME_DIR") + "/greenisland-placement-XXXXXX";
+    int fd = mkstemp(path.data());
+    if (fd < 0 || ftruncate(fd, poolSize) < 0) {
+        qWarning("Unable to create a shared memory pool in \"%s\"", path.constData());
+        wl_display_disconnect(display);
+        return;
+    }
+    unlink(path.constData());
+    wl_shm_pool *pool = wl_shm_create_pool(globals.shm, fd, poolSize);
+    close(fd);
+
+    for (int i = 0; i < m_count; i++) {
+        QSize size = windowSize(i);
+        wl_buffer *buffer = wl_shm_pool_create_buffer(pool, 0, size.width(), size.height(),
+                                                      stride, WL_SHM_FORMAT_ARGB8888);
+        wl_surface *surface = wl_compositor_create_surface(globals.compositor);
+        wl_surface_attach(surface, buffer, 0, 0);
+        wl_surface_damage(surface, 0, 0, size.width(), size.height());
+        wl_surface_commit(surface);
+    }
+
+    // Every commit was processed once the round trip is over
+    wl_display_roundtrip(display);
+    m_mapped.store(1);
+
+    // Surfaces go away with the connection
+    m_finished.acquire();
+    wl_display_disconnect(display);
+}
+
+/*
+ * main
+ */
+
+int main(int argc, char *argv[])
+{
+    // Outputs come from a fake screen configuration
+    qputenv("KSCREEN_BACKEND", QByteArray("Fake"));
+    qputenv("TEST_DATA", QByteArray(KSCREEN_DATA_DIR "/one-1920x1080.json"));
+
+    QApplication app(argc, argv);
+
+    // Command line parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QCoreApplication::translate("Command line parser", "Measure how long placing new windows takes"));
+    parser.addHelpOption();
+
+    // Number of windows
+    QCommandLineOption windowsOption(QStringList() << QStringLiteral("n") << QStringLiteral("windows"),
+                                     QCoreApplication::translate("Command line parser", "Number of windows to place"),
+                                     QStringLiteral("count"));
+    windowsOption.setDefaultValue(QStringLiteral("500"));
+    parser.addOption(windowsOption);
+
+    // Parse command line
+    parser.process(app);
+    int count = qMax(1, parser.value(windowsOption).toInt());
+
+    Compositor compositor(QString::fromLatin1(s_socket));
+    compositor.run();
+
+    Client client(count);
+
+    QTimer timer;
+    timer.setInterval(10);
+    QObject::connect(&timer, &QTimer::timeout, [&]() {
+        // Windows are mapped once the screen configuration is
+        // known, and placed once they are all mapped
+        if (compositor.outputs().isEmpty())
+            return;
+        if (!client.isRunning() && !client.isFinished()) {
+            client.start();
+            return;
+        }
+        if (!client.isMapped()) {
+            if (client.isFinished())
+                app.exit(1);
+            return;
+        }
+        timer.stop();
+
+        // Only shells map surfaces, those of the client have a size
+        // from their buffer but no role
+        QList<QWaylandSurface *> surfaces;
+        for (QWaylandSurface *surface: compositor.surfaces()) {
+            if (surface->size().isValid() && surface->windowType() == QWaylandSurface::None)
+                surfaces.append(surface);
+        }
+
+        // Each window is placed with what's left by the previous ones,
+        // like a burst of windows mapped at the same time
+        QElapsedTimer elapsed;
+        elapsed.start();
+        for (QWaylandSurface *surface: surfaces)
+            compositor.calculateInitialPosition(surface);
+        qint64 usecs = elapsed.nsecsElapsed() / 1000;
+
+        if (surfaces.isEmpty()) {
+            qWarning("No surface got a buffer");
+        } else {
+            qDebug("Placed %d windows in %lld us, %lld us per window",
+                   surfaces.size(), usecs, usecs / surfaces.size());
+        }
+
+        client.finish();
+        client.wait();
+        app.exit(surfaces.isEmpty() ? 1 : 0);
+    });
+    timer.start();
+
+    return app.exec();
+}